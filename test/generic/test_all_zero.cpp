@@ -17,6 +17,25 @@ static bool test_all_zero()
     assert(!vx::test_all_ones((I64x2){-1L,0L}));
     assert(!vx::test_all_zeros((I64x2){-1L,0L}));
     assert(vx::test_all_zeros((I64x2){0L,0L}));
+    assert(vx::test_all_zeros((I64x2){1L,0L}, (I64x2){2L,-1L}));
+
+#ifdef __AVX__
+    assert(vx::test_all_ones(vx::true_vec<I16x16>()));
+    assert(!vx::test_all_ones((I32x8){-1,-1,-1,-1,-1,-1,-1,0}));
+    assert(vx::test_all_zeros(vx::false_vec<U8x32>()));
+    assert(!vx::test_all_zeros((U64x4){0,0,0,1}));
+#endif
+
+    assert(vx::test_all_ones(vx::true_vec<I32x2>()));
+    assert(vx::test_all_zeros(vx::false_vec<U16x4>()));
+
+#ifdef __AVX512F__
+    assert(vx::test_all_ones(vx::true_vec<I64x8>()));
+    assert(!vx::test_all_ones((I64x8){-1,-1,-1,-1,-1,-1,-1,0}));
+    assert(vx::test_all_zeros(vx::false_vec<U8x64>()));
+    assert(!vx::test_all_zeros((U32x16){0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1}));
+    assert(vx::test_all_zeros((U32x16){1}, (U32x16){2}));
+#endif
 
     return true;
 }
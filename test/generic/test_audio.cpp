@@ -0,0 +1,138 @@
+#include <cstdlib>
+#include <cstdint>
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <span>
+
+#include "vx/vxaudio.hpp"
+#include "test_random.hpp"
+
+using namespace vx;
+
+// Round to nearest even and saturate, like the kernels.
+static long long saturate(double y, int bits)
+{
+    const double lo = -std::ldexp(1.0, bits - 1), hi = std::ldexp(1.0, bits - 1) - 1;
+    return (long long)std::nearbyint(std::clamp(y, lo, hi));
+}
+
+static bool test_convert()
+{
+    std::mt19937 gen(1);
+    for (std::size_t n : {0, 1, 3, 4, 5, 15, 16, 17, 33, 1000}) {
+        // out of range samples saturate
+        auto x = random_values<float>(n, gen, -1.5f, 1.5f);
+        if (n > 2) { x[0] = 1.0f; x[1] = -1.0f; }
+        const float gain = 0.75f;
+
+        std::vector<int16_t> s16(n);
+        audio::from_float(x, s16, gain);
+        std::vector<float> y(n);
+        audio::to_float(s16, y);
+        for (std::size_t i = 0; i < n; ++i) {
+            assert(s16[i] == saturate((double)(x[i] * gain * 32768.0f), 16));
+            assert(y[i] == s16[i] / 32768.0f);
+        }
+
+        std::vector<audio::int24> s24(n);
+        audio::from_float(x, s24, gain);
+        audio::to_float(s24, y, 2.0f);
+        for (std::size_t i = 0; i < n; ++i) {
+            const uint8_t* b = s24[i].bytes;
+            const int32_t v = (int32_t)((uint32_t)b[0] << 8 | (uint32_t)b[1] << 16 | (uint32_t)b[2] << 24) >> 8;
+            assert(v == saturate((double)(x[i] * gain * 8388608.0f), 24));
+            assert(y[i] == v * 2.0f / 8388608.0f);
+        }
+
+        std::vector<int32_t> s32(n);
+        audio::from_float(x, s32);
+        audio::to_float(s32, y);
+        for (std::size_t i = 0; i < n; ++i) {
+            assert(s32[i] == saturate((double)(x[i] * 2147483648.0f), 32));
+            assert(y[i] == (float)s32[i] / 2147483648.0f);
+        }
+    }
+
+    return true;
+}
+
+template <typename T>
+static bool test_interleave_type()
+{
+    for (std::size_t C : {1, 2, 3, 6, 8, 17, 40}) {
+        for (std::size_t frames : {1, 7, 16, 100}) {
+            std::vector<T> x(C * frames), p(x.size()), y(x.size());
+            for (std::size_t i = 0; i < x.size(); ++i) x[i] = (T)(i % 30000);
+            audio::deinterleave<T>(x, p, C);
+            for (std::size_t c = 0; c < C; ++c) {
+                for (std::size_t f = 0; f < frames; ++f) assert(p[c * frames + f] == x[f * C + c]);
+            }
+            audio::interleave<T>(p, y, C);
+            assert(x == y);
+        }
+    }
+
+    return true;
+}
+
+static bool test_interleave()
+{
+    return test_interleave_type<int16_t>() and test_interleave_type<float>() and test_interleave_type<double>();
+}
+
+static bool test_mix()
+{
+    std::mt19937 gen(2);
+    for (std::size_t M : {1, 2, 7, 300}) {
+        for (std::size_t n : {1, 13, 64, 1000}) {
+            std::vector<std::vector<int16_t>> s16(M, std::vector<int16_t>(n));
+            std::vector<std::vector<float>> sf(M);
+            std::vector<const int16_t*> p16(M);
+            std::vector<const float*> pf(M);
+            std::vector<float> gain(M);
+            for (std::size_t m = 0; m < M; ++m) {
+                sf[m] = random_values<float>(n, gen, -1, 1);
+                audio::from_float(sf[m], s16[m]);
+                p16[m] = s16[m].data();
+                pf[m] = sf[m].data();
+                gain[m] = (m % 3 + 1) * 2.0f / M;
+            }
+
+            std::vector<int16_t> o16(n);
+            std::vector<float> of(n), of16(n);
+            audio::mix<int16_t, int16_t>(p16, gain, o16);
+            audio::mix<int16_t, float>(p16, gain, of16);
+            audio::mix<float, float>(pf, gain, of);
+            for (std::size_t i = 0; i < n; ++i) {
+                double a = 0, b = 0;
+                for (std::size_t m = 0; m < M; ++m) {
+                    a += (double)gain[m] * s16[m][i];
+                    b += (double)gain[m] * sf[m][i];
+                }
+                const double tol = 1e-6 * (M + 1);
+                assert(std::fabs(o16[i] - std::clamp(a, -32768.0, 32767.0)) <= 0.5 + tol * 32768);
+                assert(std::fabs(of16[i] - std::clamp(a / 32768, -1.0, 1.0)) <= tol);
+                assert(std::fabs(of[i] - std::clamp(b, -1.0, 1.0)) <= tol);
+            }
+        }
+    }
+
+    return true;
+}
+
+using TestFun = bool (*)();
+
+static TestFun tests[] = {
+    test_convert, test_interleave, test_mix
+};
+
+int main(int, char**)
+{
+    for (auto test : tests) {
+        if (!test()) return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,179 @@
+#include <cstdlib>
+#include <cstdint>
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <span>
+
+#include "vx/vxblas.hpp"
+
+template <typename T>
+static std::vector<T> ramp(std::size_t n, T start)
+{
+    std::vector<T> v(n);
+    for (std::size_t i = 0; i < n; ++i) { v[i] = start + (T)((i * 7) % 13) - (T)6; }
+    return v;
+}
+
+template <typename T>
+static bool test_dot_axpy_type()
+{
+    using namespace vx::blas;
+
+    // sizes and offsets hit masked head, unrolled body and masked tail
+    for (std::size_t n : {0, 1, 3, 17, 64, 100, 259}) {
+        for (std::size_t off : {0, 1, 5}) {
+            auto bx = ramp<T>(n + off, (T)0.5);
+            auto by = ramp<T>(n + off, (T)2);
+            std::span<const T> x(bx.data() + off, n), y(by.data() + off, n);
+
+            T ref_dot = 0, ref_asum = 0;
+            for (std::size_t i = 0; i < n; ++i) { ref_dot += x[i] * y[i]; ref_asum += std::abs(x[i]); }
+            assert(dot<T>(x, y) == ref_dot); // small integers, exact
+            assert(asum<T>(x) == ref_asum);
+
+            std::vector<T> ry(by);
+            axpy<T>((T)3, x, std::span<T>(by.data() + off, n));
+            for (std::size_t i = 0; i < n; ++i) { assert(by[i + off] == (T)3 * bx[i + off] + ry[i + off]); }
+            for (std::size_t i = 0; i < off; ++i) { assert(by[i] == ry[i]); }
+
+            scal<T>((T)-2, std::span<T>(by.data() + off, n));
+            for (std::size_t i = 0; i < n; ++i) { assert(by[i + off] == (T)-2 * ((T)3 * bx[i + off] + ry[i + off])); }
+
+            std::size_t ref_imax = n;
+            for (std::size_t i = 0; i < n; ++i) {
+                if (ref_imax == n || std::abs(x[i]) > std::abs(x[ref_imax])) ref_imax = i;
+            }
+            assert(iamax<T>(x) == ref_imax);
+        }
+    }
+
+    return true;
+}
+
+static bool test_dot_axpy()
+{
+    return test_dot_axpy_type<float>() and test_dot_axpy_type<double>();
+}
+
+static bool test_nrm2()
+{
+    using namespace vx::blas;
+
+    std::vector<double> a = {3, 4};
+    assert(nrm2<double>(a) == 5);
+
+    std::vector<double> big = {3e300, 4e300, 0};
+    assert(std::abs(nrm2<double>(big) / 5e300 - 1) < 1e-15);
+
+    std::vector<double> small = {3e-300, 4e-300};
+    assert(std::abs(nrm2<double>(small) / 5e-300 - 1) < 1e-15);
+
+    std::vector<float> fbig(37, 1e30f);
+    assert(std::abs(nrm2<float>(fbig) / (1e30f * std::sqrt(37.0f)) - 1) < 1e-6f);
+
+    std::vector<double> zero(9, 0.0);
+    assert(nrm2<double>(zero) == 0);
+    assert(nrm2<double>(std::span<const double>()) == 0);
+
+    return true;
+}
+
+static bool test_compensated_sum()
+{
+    using namespace vx;
+
+    // 3 does not divide vector length, big values meet in every lane,
+    // 2^60 + 1 loses the 1 without compensation
+    std::vector<double> x;
+    for (int i = 0; i < 1000; ++i) { x.push_back(0x1p60); x.push_back(1); x.push_back(-0x1p60); }
+    std::span<const double> sx(x.data() + 1, x.size() - 1); // misaligned start
+    assert((blas::sum<double, summation::neumaier>(sx) == 1000 - 0x1p60));
+    assert((blas::sum<double, summation::plain>(std::span<const double>(x)) != 1000));
+    assert((blas::sum<double, summation::neumaier>(std::span<const double>(x)) == 1000));
+
+    std::vector<double> ones(x.size(), 1.0);
+    assert((blas::dot<double, summation::neumaier>(x, ones) == 1000));
+
+    std::vector<float> f(100001, 0.1f);
+    double ref = 0.1f * 100001.0;
+    assert(std::abs(blas::sum<float, summation::kahan>(f) - ref) / ref < 1e-7);
+    assert(std::abs(blas::asum<float, summation::kahan>(f) - ref) / ref < 1e-7);
+
+    return true;
+}
+
+static bool test_iamax_ties()
+{
+    using namespace vx::blas;
+
+    std::vector<float> x(50, 1.0f);
+    x[33] = -5; x[12] = 5; x[40] = 5;
+    assert(iamax<float>(x) == 12); // first of equal magnitudes
+
+    return true;
+}
+
+static bool test_copy()
+{
+    using namespace vx::blas;
+
+    double m[20][5];
+    for (int i = 0; i < 20; ++i) for (int j = 0; j < 5; ++j) m[i][j] = i * 10 + j;
+
+    double col[20];
+    copy(20, &m[0][3], 5, col, 1);
+    for (int i = 0; i < 20; ++i) { assert(col[i] == i * 10 + 3); }
+
+    copy(20, col, 1, &m[0][1], 5);
+    for (int i = 0; i < 20; ++i) { assert(m[i][1] == i * 10 + 3 and m[i][2] == i * 10 + 2); }
+
+    float rev[19], src[19];
+    for (int i = 0; i < 19; ++i) src[i] = (float)i;
+    copy(19, &src[18], -1, rev, 1);
+    for (int i = 0; i < 19; ++i) { assert(rev[i] == 18 - i); }
+
+    float dst[38] = {};
+    copy(19, src, 1, dst, 2);
+    for (int i = 0; i < 19; ++i) { assert(dst[2*i] == i and dst[2*i + 1] == 0); }
+
+    return true;
+}
+
+static bool test_blas_array()
+{
+    using namespace vx;
+
+    vx::array<float, 21> x, y;
+    x.fill(2.0f);
+    y.fill(3.0f);
+    assert(blas::dot(x, y) == 21 * 6.0f);
+    blas::axpy(0.5f, x, y);
+    assert(y[20] == 4.0f and blas::asum(y) == 21 * 4.0f);
+    blas::scal(-1.0f, y);
+    assert(y[0] == -4.0f);
+    x[7] = -9.0f;
+    assert(blas::iamax(x) == 7);
+    assert(x.sum() == 20 * 2.0f - 9.0f);
+
+    vx::array<double, 7> z {1e100, 1, -1e100, 1, 1e100, 1, -1e100};
+    assert(z.sum<summation::neumaier>() == 3);
+    assert((blas::sum<double, summation::neumaier>(z) == 3));
+
+    return true;
+}
+
+using TestFun = bool (*)();
+
+static TestFun tests[] = {
+    test_dot_axpy, test_nrm2, test_compensated_sum, test_iamax_ties, test_copy, test_blas_array
+};
+
+int main(int, char**)
+{
+    for (auto test : tests) {
+        if (!test()) return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
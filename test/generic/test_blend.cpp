@@ -0,0 +1,138 @@
+#include <cstdlib>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "vx/vxblend.hpp"
+#include "test_random.hpp"
+
+using namespace vx;
+using image::blend_mode;
+
+static int div255(int x) {return (x + 127) / 255;}
+static int byte(uint32_t p, int k) {return p >> 8*k & 0xFF;}
+
+// Random premultiplied pixels, color bytes not above alpha.
+static std::vector<uint32_t> random_pixels(std::size_t n, std::mt19937& gen)
+{
+    // per pixel: alpha kind, alpha and three colors
+    const auto b = random_values<uint8_t>(5*n, gen);
+    std::vector<uint32_t> v(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const uint8_t* r = &b[5*i];
+        const uint32_t a = r[0] % 4 == 0 ? 255 * (r[0] >> 2 & 1) : r[1];
+        v[i] = a << 24;
+        for (int k = 0; k < 3; ++k) v[i] |= r[2 + k] * a / 255 << 8*k;
+    }
+    return v;
+}
+
+static uint32_t reference(blend_mode mode, uint32_t s, uint32_t d)
+{
+    const int sa = byte(s, 3), da = byte(d, 3);
+    uint32_t r = 0;
+    for (int k = 0; k < 4; ++k) {
+        const int x = byte(s, k), y = byte(d, k);
+        int c = 0;
+        switch (mode) {
+        case blend_mode::src_over: c = std::min(255, x + div255(y * (255 - sa))); break;
+        case blend_mode::multiply: c = div255(x*y + x*(255 - da) + y*(255 - sa)); break;
+        case blend_mode::screen:   c = x + y - div255(x*y); break;
+        case blend_mode::add:      c = std::min(255, x + y); break;
+        }
+        r |= (uint32_t)c << 8*k;
+    }
+    return r;
+}
+
+static uint32_t scale(uint32_t p, int opacity)
+{
+    uint32_t r = 0;
+    for (int k = 0; k < 4; ++k) r |= (uint32_t)div255(byte(p, k) * opacity) << 8*k;
+    return r;
+}
+
+template <blend_mode Mode>
+static void check_blend(std::mt19937& gen)
+{
+    for (std::size_t n : {0, 1, 3, 4, 7, 8, 15, 16, 17, 37, 1000}) {
+        for (int opacity : {255, 0, 77}) {
+            const auto src = random_pixels(n, gen);
+            auto dst = random_pixels(n + 1, gen); // last pixel must stay
+            const auto before = dst;
+            image::blend<Mode>(src, std::span<uint32_t>(dst.data(), n), (uint8_t)opacity);
+            for (std::size_t i = 0; i < n; ++i) {
+                assert(dst[i] == reference(Mode, scale(src[i], opacity), before[i]));
+            }
+            assert(dst[n] == before[n]);
+        }
+    }
+}
+
+static bool test_blend()
+{
+    std::mt19937 gen(1);
+    check_blend<blend_mode::src_over>(gen);
+    check_blend<blend_mode::multiply>(gen);
+    check_blend<blend_mode::screen>(gen);
+    check_blend<blend_mode::add>(gen);
+
+    // opaque source replaces, transparent source keeps destination
+    std::vector<uint32_t> s = {0xFF102030, 0x00000000}, d = {0x80404040, 0x80404040};
+    image::blend<blend_mode::src_over>(s, d);
+    assert(d[0] == 0xFF102030 and d[1] == 0x80404040);
+    return true;
+}
+
+static bool test_premultiply()
+{
+    // every color and alpha pair, color in byte 0..2 rotating
+    std::vector<uint32_t> px(65536 + 3), pm(px.size()), back(px.size());
+    for (uint32_t i = 0; i < px.size(); ++i) {
+        const uint32_t c = i & 0xFF, a = i >> 8 & 0xFF;
+        px[i] = a << 24 | c << 8*(i % 3) | (255 - c) << 8*((i + 1) % 3);
+    }
+    image::premultiply(px, pm);
+    for (std::size_t i = 0; i < px.size(); ++i) {
+        const int a = byte(px[i], 3);
+        for (int k = 0; k < 3; ++k) assert(byte(pm[i], k) == div255(byte(px[i], k) * a));
+        assert(byte(pm[i], 3) == a);
+    }
+
+    // unpremultiply of every pair, also colors above alpha
+    image::unpremultiply(px, back);
+    for (std::size_t i = 0; i < px.size(); ++i) {
+        const int a = byte(px[i], 3);
+        for (int k = 0; k < 4; ++k) {
+            const int c = byte(px[i], k);
+            const int e = a == 0 ? 0 : k == 3 ? a : std::min(255, (c*255 + a/2) / a);
+            assert(byte(back[i], k) == e);
+        }
+    }
+
+    // round trip in place recovers premultiplied pixels exactly
+    std::mt19937 gen(5);
+    auto q = random_pixels(1001, gen);
+    const auto orig = q;
+    image::unpremultiply(q, q);
+    image::premultiply(q, q);
+    assert(q == orig);
+    return true;
+}
+
+using TestFun = bool (*)();
+
+static TestFun tests[] = {
+    test_blend, test_premultiply
+};
+
+int main(int, char**)
+{
+    for (auto test : tests) {
+        if (!test()) return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,162 @@
+#include <cstdlib>
+#include <cstdint>
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "vx/vxblur.hpp"
+#include "test_random.hpp"
+
+using namespace vx;
+using image::border;
+
+static constexpr border borders[] = {
+    border::replicate, border::reflect, border::reflect101, border::wrap, border::zero};
+
+// Pixel of image by border mode, computed directly.
+template <typename T>
+static double pixel(const std::vector<T>& img, std::ptrdiff_t stride, std::ptrdiff_t w, std::ptrdiff_t h,
+    std::ptrdiff_t x, std::ptrdiff_t y, border b)
+{
+    const auto fold = [b](std::ptrdiff_t i, std::ptrdiff_t n) -> std::ptrdiff_t {
+        while (i < 0 or i >= n) {
+            switch (b) {
+            case border::replicate: i = std::clamp(i, (std::ptrdiff_t)0, n - 1); break;
+            case border::reflect: i = i < 0 ? -i - 1 : 2*n - 1 - i; break;
+            case border::reflect101: i = n == 1 ? 0 : i < 0 ? -i : 2*n - 2 - i; break;
+            case border::wrap: i = i < 0 ? i + n : i - n; break;
+            case border::zero: return -1;
+            }
+        }
+        return i;
+    };
+    const std::ptrdiff_t fx = fold(x, w), fy = fold(y, h);
+    return fx < 0 or fy < 0 ? 0 : img[fy*stride + fx];
+}
+
+// Sizes around vector width and strip width, and tiny images smaller than kernels.
+static constexpr std::size_t sizes[][2] = {{1, 1}, {3, 2}, {17, 5}, {64, 9}, {1030, 3}, {2100, 2}};
+
+template <typename T>
+static void check_separable(std::mt19937& gen)
+{
+    const std::vector<float> kx = {0.1f, 0.2f, 0.4f, 0.2f, 0.1f}, ky = {-0.25f, 1.5f, -0.25f};
+    const double tol = std::is_same_v<T, float> ? 1e-5 : 1.0;
+    for (const auto& [w, h] : sizes) {
+        for (border b : borders) {
+            const std::size_t stride = w + 3;
+            const auto src = random_values<T>(stride * h, gen);
+            std::vector<T> dst(stride * h, 7);
+            image::separable_filter<T>(src.data(), stride, dst.data(), stride, w, h, kx, ky, b);
+            for (std::size_t y = 0; y < h; ++y) {
+                for (std::size_t x = 0; x < w; ++x) {
+                    double e = 0;
+                    for (int i = -1; i <= 1; ++i) {
+                        for (int j = -2; j <= 2; ++j) e += ky[i + 1] * kx[j + 2] * pixel(src, stride, w, h, x + j, y + i, b);
+                    }
+                    if constexpr (!std::is_same_v<T, float>) e = std::clamp(e, 0.0, (double)std::numeric_limits<T>::max());
+                    assert(std::abs(dst[y*stride + x] - e) <= tol);
+                }
+                for (std::size_t x = w; x < stride; ++x) assert(dst[y*stride + x] == 7);
+            }
+        }
+    }
+}
+
+static bool test_separable()
+{
+    std::mt19937 gen(1);
+    check_separable<uint8_t>(gen);
+    check_separable<uint16_t>(gen);
+    check_separable<float>(gen);
+    return true;
+}
+
+template <typename T>
+static void check_box(std::mt19937& gen, std::size_t max_radius)
+{
+    for (const auto& [w, h] : sizes) {
+        for (std::size_t r : {(std::size_t)0, (std::size_t)1, (std::size_t)3, max_radius}) {
+            if (r == max_radius and w > 17) continue; // reference is O(r²) per pixel
+            for (border b : borders) {
+                const std::size_t stride = w + 1;
+                const auto src = random_values<T>(stride * h, gen);
+                std::vector<T> dst(stride * h, 7);
+                image::box_blur<T>(src.data(), stride, dst.data(), stride, w, h, r, b);
+                const std::ptrdiff_t n = 2*r + 1, area = n*n;
+                for (std::ptrdiff_t y = 0; y < (std::ptrdiff_t)h; ++y) {
+                    for (std::ptrdiff_t x = 0; x < (std::ptrdiff_t)w; ++x) {
+                        double s = 0;
+                        for (std::ptrdiff_t i = -(std::ptrdiff_t)r; i <= (std::ptrdiff_t)r; ++i) {
+                            for (std::ptrdiff_t j = -(std::ptrdiff_t)r; j <= (std::ptrdiff_t)r; ++j) {
+                                s += pixel(src, stride, w, h, x + j, y + i, b);
+                            }
+                        }
+                        const T v = dst[y*stride + x];
+                        if constexpr (std::is_same_v<T, float>) assert(std::abs(v - s / area) <= 1e-4);
+                        else assert(v == ((uint64_t)s + area/2) / area);
+                    }
+                    assert(dst[y*stride + w] == 7);
+                }
+            }
+        }
+    }
+}
+
+static bool test_box()
+{
+    std::mt19937 gen(2);
+    check_box<uint8_t>(gen, 9);
+    check_box<uint16_t>(gen, 127);
+    check_box<float>(gen, 6);
+
+    // mean of a constant image is the constant, borders other than zero
+    std::vector<uint8_t> c(40*30, 200), out(c.size());
+    image::box_blur<uint8_t>(c.data(), 40, out.data(), 40, 40, 30, 5, border::replicate);
+    assert(std::all_of(out.begin(), out.end(), [](uint8_t v) {return v == 200;}));
+    return true;
+}
+
+static bool test_gaussian()
+{
+    // impulse response is the normalized kernel in both directions
+    const std::size_t w = 41, h = 41;
+    std::vector<float> src(w*h), dst(w*h);
+    src[20*w + 20] = 1;
+    const float sigma = 2.0f;
+    image::gaussian_blur<float>(src.data(), w, dst.data(), w, w, h, sigma, border::zero);
+    double sum = 0;
+    for (auto v : dst) sum += v;
+    assert(std::abs(sum - 1) < 1e-5);
+    const float g0 = dst[20*w + 20];
+    for (int d = 1; d <= 6; ++d) {
+        const float e = g0 * std::exp(-(float)(d*d) / (2*sigma*sigma));
+        assert(std::abs(dst[20*w + 20 + d] - e) < 1e-6 and std::abs(dst[(20 - d)*w + 20] - e) < 1e-6);
+    }
+    assert(dst[20*w + 27] == 0);
+
+    // integer blur of a flat image keeps it, every border mode but zero
+    std::vector<uint16_t> flat(33*7, 1000), out(flat.size());
+    for (border b : {border::replicate, border::reflect, border::reflect101, border::wrap}) {
+        image::gaussian_blur<uint16_t>(flat.data(), 33, out.data(), 33, 33, 7, 1.5f, b);
+        assert(out == flat);
+    }
+    return true;
+}
+
+using TestFun = bool (*)();
+
+static TestFun tests[] = {
+    test_separable, test_box, test_gaussian
+};
+
+int main(int, char**)
+{
+    for (auto test : tests) {
+        if (!test()) return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,161 @@
+#include <cstdlib>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <random>
+#include <vector>
+#include <span>
+
+#include "vx/vxcblas.hpp"
+#include "test_random.hpp"
+
+using namespace vx;
+
+// |a - b| within `tol` eps relative to `scale`.
+template <typename T>
+static bool close(std::complex<T> a, std::complex<long double> b, long double scale, long double tol)
+{
+    const long double eps = std::numeric_limits<T>::epsilon();
+    return std::abs(std::complex<long double>(a.real(), a.imag()) - b) <= tol * eps * scale;
+}
+
+template <typename T>
+static std::complex<long double> ld(std::complex<T> z)
+{
+    return {z.real(), z.imag()};
+}
+
+template <typename V>
+static bool test_level1_type()
+{
+    using T = typename get_base<V>::type;
+    constexpr std::size_t N = nrelem<V>();
+    std::mt19937 gen(3);
+    for (std::size_t n : {std::size_t{0}, std::size_t{1}, std::size_t{3}, N - 1, N, 2*N + 1, std::size_t{100}, std::size_t{1001}}) {
+        const auto x = random_values<std::complex<T>>(n, gen), y = random_values<std::complex<T>>(n, gen);
+        const std::complex<T> a{(T)0.75, (T)-1.25};
+
+        std::complex<long double> d{}, dc{};
+        for (std::size_t i = 0; i < n; ++i) {
+            d += ld(x[i]) * ld(y[i]);
+            dc += std::conj(ld(x[i])) * ld(y[i]);
+        }
+        const long double tol = 4 * (n + 1);
+
+        // interleaved
+        assert(close(cx::blas::dot<T>(x, y), d, 1, tol));
+        assert(close(cx::blas::dotc<T>(x, y), dc, 1, tol));
+        std::vector<std::complex<T>> z(y);
+        cx::blas::axpy<T>(a, x, z);
+        for (std::size_t i = 0; i < n; ++i) {
+            assert(close(z[i], ld(a) * ld(x[i]) + ld(y[i]), 1, 8));
+        }
+
+        // split
+        const std::size_t nv = (n + N - 1) / N;
+        std::vector<cx::Complex<V>> sx(nv), sy(nv);
+        cx::deinterleave<V>(x, sx);
+        cx::deinterleave<V>(y, sy);
+        assert(close(cx::blas::dot<V>(sx, sy), d, 1, tol));
+        assert(close(cx::blas::dotc<V>(sx, sy), dc, 1, tol));
+        cx::blas::axpy<V>(a, sx, sy);
+        cx::interleave<V>(sy, z);
+        for (std::size_t i = 0; i < n; ++i) {
+            assert(close(z[i], ld(a) * ld(x[i]) + ld(y[i]), 1, 8));
+        }
+    }
+
+    return true;
+}
+
+static bool test_level1()
+{
+    return test_level1_type<F32x4>() and test_level1_type<F64x2>()
+#ifdef __AVX2__
+        and test_level1_type<F32x8>() and test_level1_type<F64x4>()
+#endif
+#ifdef __AVX512F__
+        and test_level1_type<F32x16>() and test_level1_type<F64x8>()
+#endif
+        ;
+}
+
+static bool test_mul_add()
+{
+    const cx::Complex<F32x4> a{real: {1, 2, 0, -3}, img: {0, 1, 2, 4}};
+    const cx::Complex<F32x4> b{real: {5, -1, 3, 2}, img: {1, 1, 0, -1}};
+    const cx::Complex<F32x4> c{real: {1, 1, 1, 1}, img: {-1, -1, -1, -1}};
+    const auto p = cx::mul(a, b);
+    const auto q = cx::mul_add(a, b, c);
+    for (unsigned j = 0; j < 4; ++j) {
+        const std::complex<float> e = std::complex<float>(a.real[j], a.img[j]) * std::complex<float>(b.real[j], b.img[j]);
+        assert(p.real[j] == e.real() and p.img[j] == e.imag());
+        assert(q.real[j] == e.real() + 1 and q.img[j] == e.imag() - 1);
+    }
+
+    return true;
+}
+
+template <typename T>
+static bool test_gemm_type()
+{
+    std::mt19937 gen(11);
+    struct Dim {std::size_t m, n, k;};
+    for (const Dim d : {Dim{1, 1, 1}, Dim{3, 5, 7}, Dim{4, 16, 8}, Dim{7, 33, 19}, Dim{17, 40, 300}, Dim{130, 70, 65}, Dim{5, 9, 0}}) {
+        const std::size_t lda = d.k + 1, ldb = d.n + 3, ldc = d.n + 2;
+        const auto a = random_values<std::complex<T>>(d.m * lda, gen), b = random_values<std::complex<T>>(d.k * ldb, gen), c = random_values<std::complex<T>>(d.m * ldc, gen);
+        const auto split = [](const std::vector<std::complex<T>>& v, std::vector<T>& re, std::vector<T>& im) {
+            re.resize(v.size()); im.resize(v.size());
+            for (std::size_t i = 0; i < v.size(); ++i) { re[i] = v[i].real(); im[i] = v[i].imag(); }
+        };
+        std::vector<T> ar, ai, br, bi, cr, ci;
+        split(a, ar, ai);
+        split(b, br, bi);
+
+        for (const std::complex<T> beta : {std::complex<T>{0, 0}, std::complex<T>{1, 0}, std::complex<T>{(T)0.5, (T)-2}}) {
+            const std::complex<T> alpha{(T)1.5, (T)0.25};
+            split(c, cr, ci);
+            cx::blas::gemm<T>(d.m, d.n, d.k, alpha,
+                {real: ar.data(), img: ai.data()}, lda, {real: br.data(), img: bi.data()}, ldb,
+                beta, {real: cr.data(), img: ci.data()}, ldc);
+
+            for (std::size_t i = 0; i < d.m; ++i) {
+                for (std::size_t j = 0; j < ldc; ++j) {
+                    const std::size_t ij = i * ldc + j;
+                    if (j >= d.n) {
+                        // padding between rows is untouched
+                        assert(cr[ij] == c[ij].real() and ci[ij] == c[ij].imag());
+                        continue;
+                    }
+                    std::complex<long double> s{};
+                    for (std::size_t p = 0; p < d.k; ++p) s += ld(a[i * lda + p]) * ld(b[p * ldb + j]);
+                    const std::complex<long double> e = ld(alpha) * s + ld(beta) * ld(c[ij]);
+                    assert(close(std::complex<T>{cr[ij], ci[ij]}, e, 1, 8 * (d.k + 2)));
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool test_gemm()
+{
+    return test_gemm_type<float>() and test_gemm_type<double>();
+}
+
+using TestFun = bool (*)();
+
+static TestFun tests[] = {
+    test_mul_add, test_level1, test_gemm
+};
+
+int main(int, char**)
+{
+    for (auto test : tests) {
+        if (!test()) return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,211 @@
+#include <cstdlib>
+#include <cstdint>
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "vx/vxcolor.hpp"
+#include "test_random.hpp"
+
+using namespace vx;
+using image::pixel_format;
+
+static int clamp8(int x) {return x < 0 ? 0 : x > 255 ? 255 : x;}
+
+// Image of `w×h` pixels of `bpp` bytes with `pad` extra bytes per row.
+struct packed
+{
+    std::size_t w, h, bpp, stride;
+    std::vector<uint8_t> data;
+
+    packed(std::size_t w_, std::size_t h_, std::size_t bpp_, std::size_t pad = 0) :
+        w(w_), h(h_), bpp(bpp_), stride(w_*bpp_ + pad), data(stride*h_ + 1) {}
+
+    const uint8_t* at(std::size_t x, std::size_t y) const {return data.data() + y*stride + x*bpp;}
+};
+
+static packed random_image(std::size_t w, std::size_t h, std::size_t bpp, std::mt19937& gen)
+{
+    packed img(w, h, bpp, 5);
+    img.data = random_values<uint8_t>(img.data.size(), gen);
+    // saturated corners exercise the extremes of every formula
+    if (w > 1 and h > 1) {
+        std::fill_n(img.data.data(), 2*bpp, 255);
+        std::fill_n(img.data.data() + img.stride, 2*bpp, 0);
+    }
+    return img;
+}
+
+template <pixel_format F>
+static void rgb_of(const uint8_t* p, int& r, int& g, int& b)
+{
+    const bool swap = F == pixel_format::bgra;
+    r = p[swap ? 2 : 0]; g = p[1]; b = p[swap ? 0 : 2];
+}
+
+template <pixel_format F>
+static void check_to_yuv(const packed& img)
+{
+    const std::size_t w = img.w, h = img.h, cw = (w + 1) / 2, ch = (h + 1) / 2;
+    std::vector<uint8_t> gray(w*h), y(w*h), u(cw*ch), v(cw*ch), y2(w*h), uv(2*cw*ch);
+    image::to_gray<F>(img.data.data(), img.stride, gray.data(), w, w, h);
+    image::to_i420<F>(img.data.data(), img.stride, y.data(), w, u.data(), cw, v.data(), cw, w, h);
+    image::to_nv12<F>(img.data.data(), img.stride, y2.data(), w, uv.data(), 2*cw, w, h);
+    assert(y == y2);
+
+    for (std::size_t r = 0; r < h; ++r) {
+        for (std::size_t x = 0; x < w; ++x) {
+            int R, G, B;
+            rgb_of<F>(img.at(x, r), R, G, B);
+            assert(gray[r*w + x] == (77*R + 150*G + 29*B + 128) >> 8);
+            assert(y[r*w + x] == ((66*R + 129*G + 25*B + 128) >> 8) + 16);
+            // close to floating point BT.601
+            assert(std::abs(y[r*w + x] - (16 + (65.481*R + 128.553*G + 24.966*B) / 255)) < 1);
+        }
+    }
+    for (std::size_t r = 0; r < ch; ++r) {
+        for (std::size_t x = 0; x < cw; ++x) {
+            int sr = 0, sg = 0, sb = 0;
+            for (std::size_t dy : {0, 1}) {
+                for (std::size_t dx : {0, 1}) {
+                    int R, G, B;
+                    rgb_of<F>(img.at(std::min(2*x + dx, w - 1), std::min(2*r + dy, h - 1)), R, G, B);
+                    sr += R; sg += G; sb += B;
+                }
+            }
+            const int U = ((-38*sr - 74*sg + 112*sb + 512) >> 10) + 128;
+            const int V = ((112*sr - 94*sg - 18*sb + 512) >> 10) + 128;
+            assert(u[r*cw + x] == U and v[r*cw + x] == V);
+            assert(uv[r*2*cw + 2*x] == U and uv[r*2*cw + 2*x + 1] == V);
+        }
+    }
+}
+
+template <pixel_format F>
+static void check_from_yuv(std::size_t w, std::size_t h, std::mt19937& gen)
+{
+    constexpr std::size_t bpp = F == pixel_format::rgb ? 3 : 4;
+    const std::size_t cw = (w + 1) / 2, ch = (h + 1) / 2;
+    const auto y = random_values<uint8_t>(w*h, gen);
+    const auto u = random_values<uint8_t>(cw*ch, gen), v = random_values<uint8_t>(cw*ch, gen);
+    std::vector<uint8_t> uv(2*cw*ch);
+    for (std::size_t i = 0; i < cw*ch; ++i) {
+        uv[2*i] = u[i];
+        uv[2*i + 1] = v[i];
+    }
+
+    packed a(w, h, bpp, 3), b(w, h, bpp, 3);
+    const uint8_t guard = a.data.back();
+    image::from_i420<F>(y.data(), w, u.data(), cw, v.data(), cw, a.data.data(), a.stride, w, h);
+    image::from_nv12<F>(y.data(), w, uv.data(), 2*cw, b.data.data(), b.stride, w, h);
+    assert(a.data.back() == guard);
+
+    for (std::size_t r = 0; r < h; ++r) {
+        for (std::size_t x = 0; x < w; ++x) {
+            const int c = 298 * (y[r*w + x] - 16);
+            const int d = u[r/2*cw + x/2] - 128, e = v[r/2*cw + x/2] - 128;
+            int R, G, B;
+            rgb_of<F>(a.at(x, r), R, G, B);
+            assert(R == clamp8((c + 409*e + 128) >> 8));
+            assert(G == clamp8((c - 100*d - 208*e + 128) >> 8));
+            assert(B == clamp8((c + 516*d + 128) >> 8));
+            if (bpp == 4) assert(a.at(x, r)[3] == 255);
+            assert(std::equal(a.at(x, r), a.at(x, r) + bpp, b.at(x, r)));
+        }
+    }
+}
+
+template <pixel_format F>
+static void check_gray(std::size_t w, std::size_t h, std::mt19937& gen)
+{
+    constexpr std::size_t bpp = F == pixel_format::rgb ? 3 : 4;
+    const auto g = random_values<uint8_t>(w*h, gen);
+    std::vector<uint8_t> back(w*h);
+    packed img(w, h, bpp, 1);
+    image::from_gray<F>(g.data(), w, img.data.data(), img.stride, w, h);
+    for (std::size_t r = 0; r < h; ++r) {
+        for (std::size_t x = 0; x < w; ++x) {
+            const uint8_t* p = img.at(x, r);
+            assert(p[0] == g[r*w + x] and p[1] == g[r*w + x] and p[2] == g[r*w + x]);
+            if (bpp == 4) assert(p[3] == 255);
+        }
+    }
+    // gray weights add up to 256, gray pixels convert back exactly
+    image::to_gray<F>(img.data.data(), img.stride, back.data(), w, w, h);
+    assert(back == g);
+}
+
+static bool test_to_yuv()
+{
+    std::mt19937 gen(1);
+    for (std::size_t w : {1, 2, 3, 7, 16, 17, 33, 64, 66, 101}) {
+        for (std::size_t h : {1, 2, 5}) {
+            check_to_yuv<pixel_format::rgb>(random_image(w, h, 3, gen));
+            check_to_yuv<pixel_format::rgba>(random_image(w, h, 4, gen));
+            check_to_yuv<pixel_format::bgra>(random_image(w, h, 4, gen));
+        }
+    }
+    return true;
+}
+
+static bool test_from_yuv()
+{
+    std::mt19937 gen(2);
+    for (std::size_t w : {1, 2, 3, 7, 16, 17, 33, 64, 66, 101}) {
+        for (std::size_t h : {1, 2, 5}) {
+            check_from_yuv<pixel_format::rgb>(w, h, gen);
+            check_from_yuv<pixel_format::rgba>(w, h, gen);
+            check_from_yuv<pixel_format::bgra>(w, h, gen);
+        }
+    }
+    return true;
+}
+
+static bool test_gray()
+{
+    std::mt19937 gen(3);
+    for (std::size_t w : {1, 5, 16, 31, 64, 70}) {
+        check_gray<pixel_format::rgb>(w, 3, gen);
+        check_gray<pixel_format::rgba>(w, 3, gen);
+        check_gray<pixel_format::bgra>(w, 3, gen);
+    }
+    return true;
+}
+
+static bool test_round_trip()
+{
+    // flat color blocks survive 4:2:0 within a few levels
+    const std::size_t w = 40, h = 6, cw = w / 2, ch = h / 2;
+    packed img(w, h, 4);
+    for (std::size_t r = 0; r < h; ++r) {
+        for (std::size_t x = 0; x < w; ++x) {
+            uint8_t* p = img.data.data() + r*img.stride + x*4;
+            const std::size_t blk = x / 2 + r / 2;
+            p[0] = (uint8_t)(blk * 37); p[1] = (uint8_t)(blk * 91); p[2] = (uint8_t)(255 - blk * 13); p[3] = 255;
+        }
+    }
+    std::vector<uint8_t> y(w*h), uv(2*cw*ch);
+    image::to_nv12<pixel_format::rgba>(img.data.data(), img.stride, y.data(), w, uv.data(), 2*cw, w, h);
+    packed out(w, h, 4);
+    image::from_nv12<pixel_format::rgba>(y.data(), w, uv.data(), 2*cw, out.data.data(), out.stride, w, h);
+    for (std::size_t i = 0; i < w*h*4; ++i) {
+        assert(std::abs(img.data[i] - out.data[i]) <= 3);
+    }
+    return true;
+}
+
+using TestFun = bool (*)();
+
+static TestFun tests[] = {
+    test_to_yuv, test_from_yuv, test_gray, test_round_trip
+};
+
+int main(int, char**)
+{
+    for (auto test : tests) {
+        if (!test()) return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -1,7 +1,12 @@
 #include <cstdlib>
 #include <cstdint>
 #include <cassert>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <random>
 #include <type_traits>
+#include <vector>
 
 #include "vx/vxtypes.hpp"
 #include "vx/vxcomplex.hpp"
@@ -37,10 +42,132 @@ static bool test_complex2()
     return true;
 }
 
+// Division, modulus and polar form against std::complex<long double>.
+template <typename V>
+static bool test_complex_math_type()
+{
+    using namespace vx;
+    using T = typename get_base<V>::type;
+    using CV = cx::Complex<V>;
+    using LC = std::complex<long double>;
+    constexpr unsigned N = nrelem<V>();
+    const long double eps = std::numeric_limits<T>::epsilon();
+
+    std::mt19937_64 gen(11);
+    std::uniform_real_distribution<double> d(-10, 10);
+    std::uniform_int_distribution<int> e(-20, 20);
+    for (int i = 0; i < 5000; ++i) {
+        CV a, b;
+        for (unsigned j = 0; j < N; ++j) {
+            a.real[j] = (T)d(gen); a.img[j] = (T)d(gen);
+            b.real[j] = (T)std::ldexp(d(gen), e(gen)); b.img[j] = (T)std::ldexp(d(gen), e(gen));
+        }
+        const CV q = cx::div(a, b), p = cx::mul_scalar(a, (T)0.5);
+        const V m = cx::modulus(b), phi = cx::arg(b);
+        V r, f;
+        cx::cartesian2polar(b, r, f);
+        const CV z = cx::polar2cartesian(r, f);
+        for (unsigned j = 0; j < N; ++j) {
+            const LC la(a.real[j], a.img[j]), lb(b.real[j], b.img[j]);
+            const LC lq = la / lb;
+            assert(std::abs(LC(q.real[j], q.img[j]) - lq) <= 4 * eps * std::abs(lq));
+            assert(std::fabs(m[j] - std::abs(lb)) <= eps * std::abs(lb));
+            assert(std::fabs(phi[j] - std::arg(lb)) <= 4 * eps * std::fabs(std::arg(lb)));
+            assert(r[j] == m[j] and f[j] == phi[j]);
+            assert(std::abs(LC(z.real[j], z.img[j]) - lb) <= 4 * eps * std::abs(lb));
+            assert(p.real[j] == a.real[j] / 2 and p.img[j] == a.img[j] / 2);
+        }
+    }
+
+    // parts near overflow and underflow
+    const T big = std::numeric_limits<T>::max() / 4, small = std::numeric_limits<T>::min() * 4;
+    CV a{real: V{} + big, img: V{} + big}, b{real: V{} + big, img: V{} - big};
+    CV q = cx::div(a, b); // i
+    assert(std::fabs(q.real[0]) <= eps and std::fabs(q.img[0] - 1) <= 2 * eps);
+    a = CV{real: V{} + small, img: V{} + small}; b = CV{real: V{} + small, img: V{}};
+    q = cx::div(a, b); // 1 + i
+    assert(q.real[0] == 1 and q.img[0] == 1);
+    assert(cx::modulus(CV{real: V{} + big, img: V{} + big})[0] == std::hypot(big, big));
+    assert(cx::modulus(CV{real: V{} + 3, img: V{} - 4})[0] == 5);
+
+    return true;
+}
+
+static bool test_complex_math()
+{
+    return test_complex_math_type<vx::F32x4>() and test_complex_math_type<vx::F64x2>();
+}
+
+// Bulk conversion round trip with tails, per-vector lane order and interleaved products.
+template <typename V>
+static bool test_layout_type()
+{
+    using namespace vx;
+    using T = typename get_base<V>::type;
+    using CV = cx::Complex<V>;
+    constexpr std::size_t N = nrelem<V>();
+    const T eps = std::numeric_limits<T>::epsilon();
+
+    for (std::size_t n : {std::size_t{0}, std::size_t{1}, N/2, N - 1, N, N + 1, 3*N + N/2 + 1, std::size_t{100}}) {
+        std::vector<std::complex<T>> x(n + 1);
+        for (std::size_t i = 0; i < n + 1; ++i) x[i] = {(T)i + 1, -(T)i - (T)0.5};
+        std::vector<CV> split((n + N - 1) / N);
+        cx::deinterleave<V>(std::span(x.data(), n), split);
+        for (std::size_t i = 0; i < split.size() * N; ++i) {
+            const T re = split[i / N].real[i % N], im = split[i / N].img[i % N];
+            assert(i < n ? (re == x[i].real() and im == x[i].imag()) : (re == 0 and im == 0));
+        }
+
+        std::vector<std::complex<T>> y(n + 1, {7, 7});
+        cx::interleave<V>(split, std::span(y.data(), n));
+        for (std::size_t i = 0; i < n; ++i) assert(y[i] == x[i]);
+        assert(y[n] == std::complex<T>(7, 7)); // past the end untouched
+    }
+
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<T> d(-4, 4);
+    for (int k = 0; k < 1000; ++k) {
+        V a, b;
+        for (std::size_t j = 0; j < N; ++j) { a[j] = d(gen); b[j] = d(gen); }
+        const V p = cx::mul_interleaved(a, b), q = cx::mul_conj_interleaved(a, b), c = cx::conj_interleaved(a);
+        for (std::size_t j = 0; j < N; j += 2) {
+            const std::complex<T> ca(a[j], a[j+1]), cb(b[j], b[j+1]);
+            const std::complex<T> r1 = ca * cb, r2 = ca * std::conj(cb);
+            assert(std::abs(std::complex<T>(p[j], p[j+1]) - r1) <= 4 * eps * (std::abs(ca) * std::abs(cb)));
+            assert(std::abs(std::complex<T>(q[j], q[j+1]) - r2) <= 4 * eps * (std::abs(ca) * std::abs(cb)));
+            assert(c[j] == a[j] and c[j+1] == -a[j+1]);
+        }
+
+        // split and interleaved multiply agree
+        V lo, hi;
+        const CV sa = cx::deinterleave(a, b);
+        cx::interleave(sa, lo, hi);
+        assert(equal(lo, a) and equal(hi, b));
+    }
+
+    const V x = {1, 2}, y = {3, 4};
+    const V r = fmaddsub(x, y, broadcast<V>(1)), s = fmsubadd(x, y, broadcast<V>(1));
+    assert(r[0] == 2 and r[1] == 9 and s[0] == 4 and s[1] == 7);
+
+    return true;
+}
+
+static bool test_layout()
+{
+    bool ok = test_layout_type<vx::F32x4>() and test_layout_type<vx::F64x2>();
+#ifdef __AVX2__
+    ok = ok and test_layout_type<vx::F32x8>() and test_layout_type<vx::F64x4>();
+#endif
+#ifdef __AVX512F__
+    ok = ok and test_layout_type<vx::F32x16>() and test_layout_type<vx::F64x8>();
+#endif
+    return ok;
+}
+
 using TestFun = bool (*)();
 
 static TestFun tests[] = {
-    test_complex1, test_complex2
+    test_complex1, test_complex2, test_complex_math, test_layout
 };
 
 int main(int, char**)
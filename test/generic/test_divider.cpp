@@ -0,0 +1,105 @@
+#include <cstdlib>
+#include <cstdint>
+#include <cassert>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "vx/vxdivider.hpp"
+
+// Quotient and remainder must match scalar `/` and `%` for every element.
+template <typename V>
+static bool check(const vx::divider<typename vx::get_base<V>::type>& d, const std::vector<typename vx::get_base<V>::type>& x)
+{
+    using T = typename vx::get_base<V>::type;
+    constexpr unsigned N = vx::nrelem<V>();
+    const T dv = d.divisor();
+    for (std::size_t k = 0; k + N <= x.size(); k += N) {
+        V n, q, r;
+        for (unsigned i = 0; i < N; ++i) n[i] = x[k + i];
+        d.divmod(n, q, r);
+        const V q2 = n / d, r2 = n % d;
+        for (unsigned i = 0; i < N; ++i) {
+            if constexpr (std::is_signed_v<T>) {
+                if (dv == -1 and n[i] == std::numeric_limits<T>::min()) continue; // overflow
+            }
+            if (q[i] != n[i] / dv or r[i] != n[i] % dv or q2[i] != q[i] or r2[i] != r[i]) return false;
+        }
+    }
+    return true;
+}
+
+template <typename V>
+static bool test_divider_type()
+{
+    using T = typename vx::get_base<V>::type;
+    constexpr T lo = std::numeric_limits<T>::min(), hi = std::numeric_limits<T>::max();
+
+    std::vector<T> divisors = {1, 2, 3, 5, 6, 7, 10, 25, 125, 641, 1000, 65536, 65537, hi, hi - 1, hi / 2, hi / 2 + 1, hi / 3};
+    if constexpr (std::is_signed_v<T>) {
+        for (std::size_t i = 0, n = divisors.size(); i < n; ++i) divisors.push_back(-divisors[i]);
+        divisors.push_back(lo);
+        divisors.push_back(lo + 1);
+    }
+    std::mt19937_64 gen(7);
+    for (int i = 0; i < 300; ++i) {
+        T d = (T)(gen() >> (gen() % 64));
+        if (d != 0) divisors.push_back(d);
+    }
+
+    for (T dv : divisors) {
+        std::vector<T> x = {lo, hi, 0, 1, (T)(dv - 1), dv, (T)(dv + 1), (T)(lo + 1),
+                            (T)(0 - dv), (T)(2 * dv), (T)(0 - dv - 1), (T)(hi - 1)};
+        for (int k = 0; k < 200; ++k) x.push_back((T)(gen() >> (gen() % 64)));
+        assert(check<V>(vx::divider<T>(dv), x));
+    }
+
+    return true;
+}
+
+static bool test_divider()
+{
+    return test_divider_type<vx::U32x4>() and test_divider_type<vx::I32x4>() and
+           test_divider_type<vx::U64x2>() and test_divider_type<vx::I64x2>();
+}
+
+static bool test_divider_widths()
+{
+    using namespace vx;
+
+    const divider<uint32_t> d7(7);
+    U32x2 a = {100, 6};
+    assert(equal(a / d7, (U32x2){14, 0}));
+    const divider<int64_t> dm3(-3);
+    I64x2 c = {-10, 10};
+    assert(equal(c / dm3, (I64x2){3, -3}) and equal(c % dm3, (I64x2){-1, 1}));
+    const divider<int32_t> d10(10);
+    assert(equal((I32x2){-25, 25} / d10, (I32x2){-2, 2}));
+#ifdef __AVX2__
+    assert(equal((I32x8){} - 99, (I32x8){} - 99) and equal(((I32x8){} - 99) / d10, (I32x8){} - 9));
+    assert(equal(((U64x4){} + 50) % divider<uint64_t>(7), (U64x4){} + 1));
+#endif
+#ifdef __AVX512F__
+    U32x16 b = (U32x16){} + 0xFFFFFFFFu;
+    assert(equal(b % d7, (U32x16){} + 0xFFFFFFFFu % 7));
+    I64x8 e = (I64x8){} - 7;
+    assert(equal(e / dm3, (I64x8){} + 2));
+#endif
+
+    return true;
+}
+
+using TestFun = bool (*)();
+
+static TestFun tests[] = {
+    test_divider, test_divider_widths
+};
+
+int main(int, char**)
+{
+    for (auto test : tests) {
+        if (!test()) return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,179 @@
+#include <cstdlib>
+#include <cstdint>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <span>
+
+#include "vx/vxfft.hpp"
+#include "test_random.hpp"
+
+// Naive DFT in long double, sign -1 forward, +1 inverse.
+template <typename T>
+static void dft(const std::vector<T>& xr, const std::vector<T>& xi, std::vector<long double>& yr, std::vector<long double>& yi, int sign)
+{
+    const std::size_t n = xr.size();
+    const long double pi = 3.141592653589793238462643383279502884L;
+    std::vector<long double> c(n), s(n);
+    for (std::size_t j = 0; j < n; ++j) {
+        c[j] = std::cos(sign * 2 * pi * (long double)j / (long double)n);
+        s[j] = std::sin(sign * 2 * pi * (long double)j / (long double)n);
+    }
+    yr.assign(n, 0);
+    yi.assign(n, 0);
+    for (std::size_t k = 0; k < n; ++k) {
+        for (std::size_t j = 0; j < n; ++j) {
+            const std::size_t jk = (j * k) % n;
+            yr[k] += xr[j] * c[jk] - xi[j] * s[jk];
+            yi[k] += xr[j] * s[jk] + xi[j] * c[jk];
+        }
+    }
+}
+
+// Max error relative to `eps * log2(n) * rms(y)`, FFT error grows like sqrt(log n) on average.
+template <typename T>
+static bool close(const T* r, const T* i, const std::vector<long double>& yr, const std::vector<long double>& yi, std::size_t stride = 1)
+{
+    const std::size_t n = yr.size();
+    long double rms = 0, err = 0;
+    for (std::size_t k = 0; k < n; ++k) {
+        rms += yr[k] * yr[k] + yi[k] * yi[k];
+        err = std::max(err, std::hypot(r[k * stride] - yr[k], i[k * stride] - yi[k]));
+    }
+    rms = std::sqrt(rms / n);
+    const long double eps = std::numeric_limits<T>::epsilon();
+    return err <= 4 * eps * (std::log2((long double)n) + 1) * rms;
+}
+
+template <typename T>
+static bool test_complex_type()
+{
+    std::mt19937 gen(5);
+    for (std::size_t n : {1, 2, 3, 4, 5, 7, 8, 12, 15, 16, 32, 49, 64, 97, 100, 128, 192, 256, 360, 1000, 1024, 3072, 4096}) {
+        vx::fft::plan<T> p(n);
+        assert(p.size() == n);
+        const auto xr = random_values<T>(n, gen), xi = random_values<T>(n, gen);
+        std::vector<long double> yr, yi;
+
+        std::vector<T> re(xr), im(xi);
+        p.forward(re, im);
+        dft(xr, xi, yr, yi, -1);
+        assert(close(re.data(), im.data(), yr, yi));
+
+        // unnormalized inverse
+        p.inverse(re, im);
+        std::vector<long double> nr(n), ni(n);
+        for (std::size_t k = 0; k < n; ++k) { nr[k] = (long double)xr[k] * n; ni[k] = (long double)xi[k] * n; }
+        assert(close(re.data(), im.data(), nr, ni));
+
+        std::vector<T> br(xr), bi(xi);
+        p.inverse(br, bi);
+        dft(xr, xi, yr, yi, 1);
+        assert(close(br.data(), bi.data(), yr, yi));
+    }
+
+    return true;
+}
+
+static bool test_complex()
+{
+    return test_complex_type<float>() and test_complex_type<double>();
+}
+
+// Batch is the same as transforms one by one.
+static bool test_batch()
+{
+    std::mt19937 gen(7);
+    for (std::size_t n : {6, 64, 256}) {
+        vx::fft::plan<float> p(n);
+        auto re = random_values<float>(3 * n, gen), im = random_values<float>(3 * n, gen);
+        std::vector<float> r1(re), i1(im);
+        p.forward(re, im);
+        for (std::size_t b = 0; b < 3; ++b) {
+            p.forward(std::span<float>(r1.data() + b * n, n), std::span<float>(i1.data() + b * n, n));
+        }
+        assert(re == r1 and im == i1);
+    }
+
+    return true;
+}
+
+template <typename T>
+static bool test_real_type()
+{
+    std::mt19937 gen(9);
+    for (std::size_t n : {1, 2, 3, 4, 6, 9, 10, 16, 30, 64, 250, 512, 2048}) {
+        vx::fft::real_plan<T> p(n);
+        const std::size_t nb = p.bins();
+        assert(nb == n / 2 + 1);
+
+        const std::size_t batch = 2;
+        const auto x = random_values<T>(batch * n, gen);
+        std::vector<T> re(batch * nb), im(batch * nb);
+        p.forward(x, re, im);
+
+        for (std::size_t b = 0; b < batch; ++b) {
+            std::vector<T> xr(x.begin() + b * n, x.begin() + (b + 1) * n), xi(n);
+            std::vector<long double> yr, yi;
+            dft(xr, xi, yr, yi, -1);
+            yr.resize(nb);
+            yi.resize(nb);
+            assert(close(re.data() + b * nb, im.data() + b * nb, yr, yi));
+        }
+
+        std::vector<T> y(batch * n);
+        p.inverse(re, im, y);
+        const long double eps = std::numeric_limits<T>::epsilon();
+        for (std::size_t j = 0; j < batch * n; ++j) {
+            assert(std::fabs((long double)y[j] - (long double)x[j] * n) <= 4 * eps * n * (std::log2((long double)n) + 1));
+        }
+    }
+
+    return true;
+}
+
+static bool test_real()
+{
+    return test_real_type<float>() and test_real_type<double>();
+}
+
+static bool test_transpose()
+{
+    using namespace vx;
+
+    F32x4 m[4] = {{0,1,2,3}, {4,5,6,7}, {8,9,10,11}, {12,13,14,15}};
+    transpose(m);
+    for (unsigned i = 0; i < 4; ++i) {
+        for (unsigned j = 0; j < 4; ++j) assert(m[i][j] == (float)(j * 4 + i));
+    }
+
+#ifdef __AVX512F__
+    F64x8 d[8];
+    for (unsigned i = 0; i < 8; ++i) {
+        for (unsigned j = 0; j < 8; ++j) d[i][j] = i * 8 + j;
+    }
+    transpose(d);
+    for (unsigned i = 0; i < 8; ++i) {
+        for (unsigned j = 0; j < 8; ++j) assert(d[i][j] == j * 8 + i);
+    }
+#endif
+
+    return true;
+}
+
+using TestFun = bool (*)();
+
+static TestFun tests[] = {
+    test_transpose, test_complex, test_batch, test_real
+};
+
+int main(int, char**)
+{
+    for (auto test : tests) {
+        if (!test()) return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,159 @@
+#include <cstdlib>
+#include <cstdint>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <span>
+
+#include "vx/vxfir.hpp"
+#include "test_random.hpp"
+
+// Full convolution in long double.
+template <typename T>
+static std::vector<long double> convolution(const std::vector<T>& x, const std::vector<T>& h)
+{
+    std::vector<long double> y(x.size() + h.size() - 1);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        for (std::size_t j = 0; j < h.size(); ++j) y[i + j] += (long double)x[i] * h[j];
+    }
+    return y;
+}
+
+// Error bound relative to `∑|x||h|` scale, FFT path adds log factor.
+template <typename T>
+static bool close(const T* y, const long double* e, std::size_t n, std::size_t m)
+{
+    const long double eps = std::numeric_limits<T>::epsilon();
+    const long double tol = 8 * eps * std::sqrt((long double)m) * (std::log2((long double)m) + 4);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (std::fabs(y[i] - e[i]) > tol) return false;
+    }
+    return true;
+}
+
+template <typename T>
+static bool test_float_type()
+{
+    std::mt19937 gen(1);
+    for (std::size_t m : {1, 2, 3, 7, 16, 33, 127, 128, 129, 200, 512}) {
+        for (std::size_t nx : {m, m + 1, m + 17, 3 * m + 100, std::size_t{2000}}) {
+            const auto x = random_values<T>(nx, gen), h = random_values<T>(m, gen);
+            const auto full = convolution(x, h);
+
+            std::vector<T> y(nx + m - 1);
+            vx::convolve<T>(x, h, y);
+            assert(close(y.data(), full.data(), y.size(), m));
+
+            // correlation with h is convolution with reversed h, valid part
+            std::vector<T> c(nx - m + 1), hr(h.rbegin(), h.rend());
+            vx::correlate<T>(x, hr, c);
+            assert(close(c.data(), full.data() + m - 1, c.size(), m));
+        }
+    }
+
+    return true;
+}
+
+static bool test_float()
+{
+    return test_float_type<float>() and test_float_type<double>();
+}
+
+// Q15 reference: round half up and saturate.
+static int16_t q15(long double s)
+{
+    const long double r = std::floor(s / 32768 + 0.5L);
+    return (int16_t)std::clamp<long double>(r, INT16_MIN, INT16_MAX);
+}
+
+static bool test_q15()
+{
+    std::mt19937 gen(2);
+    for (std::size_t m : {1, 2, 3, 5, 16, 31, 64, 129}) {
+        for (std::size_t nx : {m, m + 1, m + 40, std::size_t{1000}}) {
+            auto x = random_values<int16_t>(nx, gen), h = random_values<int16_t>(m, gen);
+            // keep ∑|h| below 65536
+            for (auto& v : h) v = (int16_t)(v / (int)(m + 1));
+            const auto full = convolution(x, h);
+
+            std::vector<int16_t> y(nx + m - 1);
+            vx::convolve<int16_t>(x, h, y);
+            for (std::size_t i = 0; i < y.size(); ++i) assert(y[i] == q15(full[i]));
+        }
+    }
+
+    // saturation
+    std::vector<int16_t> x(100, INT16_MAX), h{INT16_MAX, INT16_MAX}, y(99);
+    vx::correlate<int16_t>(x, h, y);
+    for (auto v : y) assert(v == INT16_MAX);
+
+    return true;
+}
+
+// Streaming in blocks of any size is the same as one convolution,
+// bit-exact below FFT size.
+template <typename T>
+static bool test_stream_type()
+{
+    std::mt19937 gen(3);
+    for (std::size_t m : {1, 5, 40, 64, 128, 300}) {
+        auto h = random_values<T>(m, gen), x = random_values<T>(20000, gen);
+        if constexpr (!std::is_floating_point_v<T>) {
+            for (auto& v : h) v = (int16_t)(v / (int)(m + 1));
+        }
+        const auto full = convolution(x, h);
+
+        vx::fir<T> f(h);
+        assert(f.taps() == m);
+        std::vector<T> y(x);
+        std::size_t s = 0, len = 1;
+        while (s < y.size()) {
+            const std::size_t n = std::min(len, y.size() - s);
+            std::span<T> block(y.data() + s, n);
+            f.process(block, block);
+            s += n;
+            len = len * 3 + 1;
+        }
+        for (std::size_t i = 0; i < y.size(); ++i) {
+            if constexpr (std::is_floating_point_v<T>) assert(close(&y[i], &full[i], 1, m));
+            else assert(y[i] == q15(full[i]));
+        }
+
+        // same result after reset
+        f.reset();
+        std::vector<T> z(x.size());
+        f.process(x, z);
+        for (std::size_t i = 0; i < z.size(); ++i) {
+            if constexpr (std::is_floating_point_v<T>) {
+                assert(close(&z[i], &full[i], 1, m));
+                // direct path sums taps in the same order whatever the blocks are
+                if (m < vx::fir_fft_taps) assert(z[i] == y[i]);
+            }
+            else assert(z[i] == y[i]);
+        }
+    }
+
+    return true;
+}
+
+static bool test_stream()
+{
+    return test_stream_type<float>() and test_stream_type<double>() and test_stream_type<int16_t>();
+}
+
+using TestFun = bool (*)();
+
+static TestFun tests[] = {
+    test_float, test_q15, test_stream
+};
+
+int main(int, char**)
+{
+    for (auto test : tests) {
+        if (!test()) return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
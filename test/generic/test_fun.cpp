@@ -1,6 +1,7 @@
 #include <cstdlib>
 #include <cstdint>
 #include <cassert>
+#include <cmath>
 #include <type_traits>
 
 #include "vx/vxtypes.hpp"
@@ -22,6 +23,10 @@ static bool test_dot()
     double c = vx::dot<double>(a, b);
     assert(c == (1.0*5.0 + 2.0*6.0));
 #endif
+
+    I32x4 d{1,2,3,4};
+    assert(vx::dot<int>(d, d) == 1+4+9+16);
+
     return true;
 }
 
@@ -37,13 +42,138 @@ static bool test_inverse()
     F32x4 b_inv = vx::inverse(b);
     assert(vx::equal(b_inv, F32x4{-1,2,-3,4}));
 
+    F64x2 c{1,-2};
+    assert(vx::equal(vx::inverse(c), F64x2{-1,2}));
+
+    return true;
+}
+
+static bool test_reduce()
+{
+    using namespace vx;
+
+    U8x16 a = (U8x16){} + 255;
+    assert(sum<uint32_t>(a) == 255*16);
+    assert(sum<uint8_t>(a) == (uint8_t)(255*16));
+
+    I8x16 b = (I8x16){} + (int8_t)-128;
+    b[3] = 127;
+    assert(sum<int>(b) == -128*15 + 127);
+
+    U16x8 c = (U16x8){} + 65535;
+    assert(sum<uint32_t>(c) == 65535u*8);
+    I16x8 d = {-32768, 32767, -1, 1, 5, -5, 100, -200};
+    assert(sum<int32_t>(d) == -32768 + 32767 - 100);
+
+    I32x4 e = {INT32_MAX, INT32_MAX, 1, -3};
+    assert(sum<int64_t>(e) == 2LL*INT32_MAX - 2);
+
+    F32x4 f = {1e8f, 1.0f, -1e8f, 1.0f};
+    assert(sum<double>(f) == 2.0);
+
+    I32x4 g = {3, -7, 12, 5};
+    assert(reduce_min(g) == -7 and reduce_max(g) == 12);
+    assert(reduce_and((U32x4){0xF0F, 0xFF0, 0xF00, 0xF01}) == 0xF00);
+    assert(reduce_or((U32x4){1, 2, 4, 8}) == 0xF);
+    assert(reduce_xor((U32x4){1, 3, 4, 4}) == 2);
+
+    U16x8 h = {7, 3, 9, 65535, 4, 3, 8, 1000};
+    assert(reduce_min(h) == 3 and reduce_max(h) == 65535);
+
+    U8x8 i = {1,2,3,4,5,6,7,200};
+    assert(sum<int>(i) == 228);
+    assert(reduce_max(i) == 200);
+
+#ifdef __AVX__
+    F64x4 j = {1.5, -2, 8, 0.5};
+    assert(sum<double>(j) == 8.0);
+    assert(reduce_min(j) == -2 and reduce_max(j) == 8);
+    I8x32 k = (I8x32){} - 1;
+    assert(sum<int>(k) == -32);
+    assert(reduce_and(k) == -1);
+#endif
+#ifdef __AVX512F__
+    U8x64 l = (U8x64){} + 200;
+    assert(sum<uint32_t>(l) == 200*64);
+    I16x32 m = (I16x32){} + 32767;
+    assert(sum<int32_t>(m) == 32767*32);
+    F32x16 n = (F32x16){} + 0.25f;
+    n[15] = -100.f;
+    assert(sum<float>(n) == 0.25f*15 - 100.f);
+    assert(reduce_min(n) == -100.f and reduce_max(n) == 0.25f);
+    I64x8 o = {1,2,3,4,5,6,7,-8};
+    assert(sum<int64_t>(o) == 20 and reduce_xor(o) == (1^2^3^4^5^6^7^-8));
+#endif
+
+    return true;
+}
+
+// Vectors wider than the ISA split in halves, built also with -march below AVX-512.
+static bool test_reduce_wide()
+{
+    using namespace vx;
+
+    I8x32 a = (I8x32){} + 1;
+    a[5] = -128;
+    assert(sum<int>(a) == 31 - 128);
+    I8x64 b = (I8x64){} + 1;
+    assert(sum<int>(b) == 64);
+    b[63] = -128; b[0] = 127;
+    assert(sum<int>(b) == 62 - 128 + 127);
+    U8x64 c = (U8x64){} + 255;
+    assert(sum<uint32_t>(c) == 255*64);
+
+    U16x16 d = (U16x16){} + 1;
+    assert(sum<uint32_t>(d) == 16);
+    U16x32 e = (U16x32){} + 1;
+    e[7] = 65535;
+    assert(sum<uint32_t>(e) == 31 + 65535);
+    I16x32 f = (I16x32){} - 1;
+    f[0] = -32768;
+    assert(sum<int32_t>(f) == -31 - 32768);
+
+    return true;
+}
+
+static bool test_compensated()
+{
+    using namespace vx;
+
+    accumulator<summation::neumaier, F64x2> n;
+    accumulator<summation::plain, F64x2> p;
+    for (int i = 0; i < 100; ++i) {
+        n.add((F64x2){0x1p60, 1}); n.add((F64x2){1, -0x1p60});
+        p.add((F64x2){0x1p60, 1}); p.add((F64x2){1, -0x1p60});
+    }
+    assert(n.result() == 200);
+    assert(p.result() != 200);
+
+    accumulator<summation::kahan, F32x4> k;
+    double ref = 0;
+    for (int i = 0; i < 100000; ++i) {
+        F32x4 v = (F32x4){0.1f, 0.2f, 0.3f, 0.4f} * (float)(1 + i % 7);
+        k.add(v);
+        for (int j = 0; j < 4; ++j) ref += v[j];
+    }
+    assert(std::fabs(k.result() - ref) / ref < 1e-7);
+
+    // a*b == 1 - 2^-60 rounds to 1, FMA recovers the lost bits
+    const double a = 1 + 0x1p-30, b = 1 - 0x1p-30;
+    const double d = vx::dot<double, summation::neumaier>((F64x2){a, -1}, (F64x2){b, 1});
+#ifdef __FMA__
+    assert(d == -0x1p-60);
+#else
+    assert(d == 0);
+#endif
+    assert((vx::dot<double, summation::plain>((F64x2){a, -1}, (F64x2){b, 1}) == 0));
+
     return true;
 }
 
 using TestFun = bool (*)();
 
 static TestFun tests[] = {
-    test_dot, test_inverse
+    test_dot, test_inverse, test_reduce, test_reduce_wide, test_compensated
 };
 
 int main(int, char**)
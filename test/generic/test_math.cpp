@@ -0,0 +1,467 @@
+#include <cstdlib>
+#include <cstdint>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include "vx/vxmath.hpp"
+
+// Documented bounds are for FMA, mul and add round twice otherwise.
+#ifdef __FMA__
+static constexpr double slack = 0;
+#else
+static constexpr double slack = 0.5;
+#endif
+
+// Error of `got` in units of last place of T at exact value `ref`.
+template <typename T>
+static double ulp_error(T got, long double ref)
+{
+    if (std::fabs(ref) > std::numeric_limits<T>::max()) ref = std::copysign(INFINITY, ref); // overflow
+    if (std::isnan(ref)) return std::isnan(got) ? 0 : 1e9;
+    if (std::isinf(ref) or std::isinf(got)) return (long double)got == ref ? 0 : 1e9;
+    if (ref == 0) return got == 0 ? 0 : 1e9;
+    int e = std::max(std::ilogb(ref), std::numeric_limits<T>::min_exponent - 1);
+    long double ulp = std::ldexp(1.0L, e - (std::numeric_limits<T>::digits - 1));
+    return (double)(std::fabs((long double)got - ref) / ulp);
+}
+
+// Max error of vector function `f` against `ref` on random arguments in [lo, hi],
+// or in [2^lo, 2^hi] log-uniform when `log_scale` is set.
+template <typename V, typename F, typename R>
+static double max_ulp(F f, R ref, double lo, double hi, bool log_scale = false, int count = 20000)
+{
+    using T = typename vx::get_base<V>::type;
+    std::mt19937_64 gen(12345);
+    std::uniform_real_distribution<double> dist(lo, hi);
+    double worst = 0;
+    for (int i = 0; i < count; ++i) {
+        V x;
+        for (unsigned j = 0; j < vx::nrelem<V>(); ++j) {
+            x[j] = (T)(log_scale ? std::exp2(dist(gen)) : dist(gen));
+        }
+        V y = f(x);
+        for (unsigned j = 0; j < vx::nrelem<V>(); ++j) {
+            worst = std::max(worst, ulp_error<T>(y[j], ref((long double)x[j])));
+        }
+    }
+    return worst;
+}
+
+template <typename V>
+static bool test_poly_type()
+{
+    using namespace vx;
+    using T = typename get_base<V>::type;
+
+    // integer coefficients and arguments are exact in both schemes
+    const V x = {2, -3};
+    static constexpr int c[] = {1, -2, 3, -4, 5, -6, 7, -8, 9, -10, 11};
+    auto ref = [&](std::size_t k, T v) {T r = 0; for (std::size_t i = k; i-- > 0;) r = r * v + (T)c[i]; return r;};
+    auto check = [&](auto f, std::size_t k) {
+        const V y = f(x);
+        return y[0] == ref(k, x[0]) and y[1] == ref(k, x[1]);
+    };
+    assert(check([](V v) {return vx::poly<1>(v);}, 1));
+    assert(check([](V v) {return vx::poly<1, -2>(v);}, 2));
+    assert(check([](V v) {return vx::poly<1, -2, 3>(v);}, 3));
+    assert(check([](V v) {return vx::poly<1, -2, 3, -4, 5, -6>(v);}, 6));
+    assert(check([](V v) {return vx::poly<1, -2, 3, -4, 5, -6, 7>(v);}, 7));
+    assert(check([](V v) {return vx::poly<1, -2, 3, -4, 5, -6, 7, -8, 9>(v);}, 9));
+    assert(check([](V v) {return vx::estrin(v, c);}, 11));
+    assert(check([](V v) {return vx::horner(v, c);}, 11));
+
+    // Taylor series of e^x, Estrin and Horner agree to rounding
+    auto e9 = [](V v) {return vx::poly<1.0, 1.0, 1.0/2, 1.0/6, 1.0/24, 1.0/120, 1.0/720, 1.0/5040, 1.0/40320>(v);};
+    auto ref9 = [](long double v) {
+        long double r = 0, t = 1;
+        for (int i = 1; i <= 9; ++i) { r += t; t *= v / i; }
+        return r;
+    };
+    assert(max_ulp<V>(e9, ref9, -1, 1) <= 2.5 + slack);
+    assert(std::fabs(e9(broadcast<V>(1))[0] - (T)2.71827877) < 1e-6);
+
+    return true;
+}
+
+template <typename V>
+static bool test_exp_type()
+{
+    using namespace vx;
+    using T = typename get_base<V>::type;
+    constexpr bool f32 = std::is_same_v<T, float>;
+    const double big = f32 ? 88 : 709, tiny = f32 ? -103 : -744;
+
+    assert(max_ulp<V>([](V x) {return vx::exp(x);}, [](long double x) {return expl(x);}, tiny, big) <= 1.01 + slack);
+    assert(max_ulp<V>([](V x) {return vx::exp(x);}, [](long double x) {return expl(x);}, -1, 1) <= 1 + slack);
+    assert(max_ulp<V>([](V x) {return vx::exp<accuracy::fast>(x);}, [](long double x) {return expl(x);}, -87, 87) <= 3 + slack);
+    assert(max_ulp<V>([](V x) {return vx::exp2(x);}, [](long double x) {return exp2l(x);}, tiny * 1.44, big * 1.44) <= 1 + slack);
+    assert(max_ulp<V>([](V x) {return vx::exp2<accuracy::fast>(x);}, [](long double x) {return exp2l(x);}, -125, 125) <= 3 + slack);
+    assert(max_ulp<V>([](V x) {return vx::expm1(x);}, [](long double x) {return expm1l(x);}, -40, big) <= 2 + slack);
+    assert(max_ulp<V>([](V x) {return vx::expm1(x);}, [](long double x) {return expm1l(x);}, -1e-3, 1e-3) <= 2 + slack);
+    assert(max_ulp<V>([](V x) {return vx::expm1<accuracy::fast>(x);}, [](long double x) {return expm1l(x);}, -1, 1) <= 3 + slack);
+
+    const T inf = std::numeric_limits<T>::infinity(), nan = std::numeric_limits<T>::quiet_NaN();
+    V s{}; s[0] = inf; s[1] = -inf;
+    V e = vx::exp(s);
+    assert(e[0] == inf and e[1] == 0);
+    e = vx::expm1(s);
+    assert(e[0] == inf and e[1] == -1);
+    s[0] = nan; s[1] = (T)2000;
+    e = vx::exp2(s);
+    assert(std::isnan(e[0]) and e[1] == inf);
+
+    return true;
+}
+
+template <typename V>
+static bool test_log_type()
+{
+    using namespace vx;
+    using T = typename get_base<V>::type;
+    constexpr bool f32 = std::is_same_v<T, float>;
+    const double emin = f32 ? -149 : -1074, emax = f32 ? 127 : 1023;
+
+    assert(max_ulp<V>([](V x) {return vx::log(x);}, [](long double x) {return logl(x);}, emin, emax, true) <= 1.5 + slack);
+    assert(max_ulp<V>([](V x) {return vx::log(x);}, [](long double x) {return logl(x);}, 0.5, 2) <= 1.5 + slack);
+    assert(max_ulp<V>([](V x) {return vx::log<accuracy::fast>(x);}, [](long double x) {return logl(x);}, -100, 100, true) <= 3 + slack);
+    assert(max_ulp<V>([](V x) {return vx::log2(x);}, [](long double x) {return log2l(x);}, emin, emax, true) <= 2 + slack);
+    assert(max_ulp<V>([](V x) {return vx::log2(x);}, [](long double x) {return log2l(x);}, 0.5, 2) <= 2 + slack);
+    assert(max_ulp<V>([](V x) {return vx::log2<accuracy::fast>(x);}, [](long double x) {return log2l(x);}, 0.5, 2) <= 4 + slack);
+    assert(max_ulp<V>([](V x) {return vx::log1p(x);}, [](long double x) {return log1pl(x);}, -0.999, 10) <= 2 + slack);
+    assert(max_ulp<V>([](V x) {return vx::log1p(x);}, [](long double x) {return log1pl(x);}, -1e-4, 1e-4) <= 2 + slack);
+    assert(max_ulp<V>([](V x) {return vx::log1p(x);}, [](long double x) {return log1pl(x);}, -60, emax, true) <= 2 + slack);
+    assert(max_ulp<V>([](V x) {return vx::log1p<accuracy::fast>(x);}, [](long double x) {return log1pl(x);}, -0.9, 10) <= 3 + slack);
+
+    const T inf = std::numeric_limits<T>::infinity();
+    V s{}; s[0] = inf; s[1] = -1;
+    V l = vx::log(s);
+    assert(l[0] == inf and std::isnan(l[1]));
+    s[0] = 0; s[1] = std::numeric_limits<T>::denorm_min();
+    l = vx::log2(s);
+    assert(l[0] == -inf and l[1] == (f32 ? -149 : -1074));
+    s[0] = -1; s[1] = -2;
+    l = vx::log1p(s);
+    assert(l[0] == -inf and std::isnan(l[1]));
+
+    return true;
+}
+
+template <typename V>
+static bool test_pow_type()
+{
+    using namespace vx;
+    using T = typename get_base<V>::type;
+    constexpr bool f32 = std::is_same_v<T, float>;
+
+    std::mt19937_64 gen(777);
+    std::uniform_real_distribution<double> ex(f32 ? -20 : -200, f32 ? 20 : 200), ey(-6, 6);
+    double worst = 0, worst_fast = 0;
+    for (int i = 0; i < 20000; ++i) {
+        V x, y;
+        for (unsigned j = 0; j < nrelem<V>(); ++j) {
+            x[j] = (T)std::exp2(ex(gen));
+            y[j] = (T)ey(gen);
+        }
+        V r = vx::pow(x, y), rf = vx::pow<accuracy::fast>(x, y);
+        for (unsigned j = 0; j < nrelem<V>(); ++j) {
+            long double ref = powl(x[j], y[j]);
+            worst = std::max(worst, ulp_error<T>(r[j], ref));
+            if (std::fabs(std::log2(x[j]) * y[j]) < 120) {
+                worst_fast = std::max(worst_fast, ulp_error<T>(rf[j], ref));
+            }
+        }
+    }
+    assert(worst <= 1 + slack);
+    assert(worst_fast <= (f32 ? 128 : 64));
+
+    // C99 special values
+    const T inf = std::numeric_limits<T>::infinity(), nan = std::numeric_limits<T>::quiet_NaN();
+    const T xs[] = {-2, -2,  -2,  -0.0, -0.0, 0,  -1,   1,   nan, 2,    0.5, -inf, -inf, 4};
+    const T ys[] = {3,  2,   0.5, 3,    -3,   -2, inf,  nan, 0,   -inf, inf, 3,    0.5,  0.5};
+    for (unsigned i = 0; i < sizeof xs / sizeof xs[0]; ++i) {
+        V x = broadcast<V>(xs[i]), y = broadcast<V>(ys[i]);
+        T r = vx::pow(x, y)[0], ref = std::pow(xs[i], ys[i]);
+        assert((std::isnan(r) and std::isnan(ref)) or (r == ref and std::signbit(r) == std::signbit(ref)));
+    }
+
+    return true;
+}
+
+template <typename V>
+static bool test_trig_type()
+{
+    using namespace vx;
+    using T = typename get_base<V>::type;
+    constexpr bool f32 = std::is_same_v<T, float>;
+    const double huge = f32 ? 16000 : 1e6;
+
+    assert(max_ulp<V>([](V x) {return vx::sin(x);}, [](long double x) {return sinl(x);}, -4, 4) <= 1 + slack);
+    assert(max_ulp<V>([](V x) {return vx::sin(x);}, [](long double x) {return sinl(x);}, -huge, huge) <= 1 + slack);
+    assert(max_ulp<V>([](V x) {return vx::sin(x);}, [](long double x) {return sinl(x);}, -1e30, 1e30) <= 1);
+    assert(max_ulp<V>([](V x) {return vx::sin<accuracy::fast>(x);}, [](long double x) {return sinl(x);}, -huge, huge) <= 1 + slack);
+    assert(max_ulp<V>([](V x) {return vx::cos(x);}, [](long double x) {return cosl(x);}, -4, 4) <= 1 + slack);
+    assert(max_ulp<V>([](V x) {return vx::cos(x);}, [](long double x) {return cosl(x);}, -huge, huge) <= 1 + slack);
+    assert(max_ulp<V>([](V x) {return vx::tan(x);}, [](long double x) {return tanl(x);}, -4, 4) <= 2.5 + slack);
+    assert(max_ulp<V>([](V x) {return vx::tan(x);}, [](long double x) {return tanl(x);}, -huge, huge) <= 2.5 + slack);
+    assert(max_ulp<V>([](V x) {return vx::asin(x);}, [](long double x) {return asinl(x);}, -1, 1) <= 2.5 + slack);
+    assert(max_ulp<V>([](V x) {return vx::acos(x);}, [](long double x) {return acosl(x);}, -1, 1) <= 1.5 + slack);
+    assert(max_ulp<V>([](V x) {return vx::atan(x);}, [](long double x) {return atanl(x);}, -4, 4) <= 1.5 + slack);
+    assert(max_ulp<V>([](V x) {return vx::atan(x);}, [](long double x) {return atanl(x);}, -30, 30, true) <= 1.5 + slack);
+
+    std::mt19937_64 gen(99);
+    std::uniform_real_distribution<double> dist(-10, 10);
+    double worst = 0;
+    for (int i = 0; i < 20000; ++i) {
+        V x, y;
+        for (unsigned j = 0; j < nrelem<V>(); ++j) { x[j] = (T)dist(gen); y[j] = (T)dist(gen); }
+        V r = vx::atan2(y, x), s, c;
+        vx::sincos(x, s, c);
+        for (unsigned j = 0; j < nrelem<V>(); ++j) {
+            worst = std::max(worst, ulp_error<T>(r[j], atan2l(y[j], x[j])));
+            assert(s[j] == vx::sin(x)[j] and c[j] == vx::cos(x)[j]);
+        }
+    }
+    assert(worst <= 1.5 + slack);
+
+    // magnitudes log-uniform over most of the range: large |y/x|, tiny |x|
+    std::uniform_real_distribution<double> mag(f32 ? -120 : -1000, f32 ? 120 : 1000);
+    std::bernoulli_distribution neg;
+    worst = 0;
+    for (int i = 0; i < 20000; ++i) {
+        V x, y;
+        for (unsigned j = 0; j < nrelem<V>(); ++j) {
+            x[j] = (T)((neg(gen) ? -1 : 1) * std::exp2(mag(gen)));
+            y[j] = (T)((neg(gen) ? -1 : 1) * std::exp2(mag(gen) / 8));
+        }
+        V r = vx::atan2(y, x);
+        for (unsigned j = 0; j < nrelem<V>(); ++j) worst = std::max(worst, ulp_error<T>(r[j], atan2l(y[j], x[j])));
+    }
+    assert(worst <= 1.5 + slack);
+
+    // special values against libm
+    const T inf = std::numeric_limits<T>::infinity(), nan = std::numeric_limits<T>::quiet_NaN();
+    const T xs[] = {-0.0, 0, inf, -inf, nan, 1, -1, 2};
+    auto same = [](T a, T b) {
+        return (std::isnan(a) and std::isnan(b)) or (std::signbit(a) == std::signbit(b) and
+            std::fabs(a - b) <= std::fabs(b) * 4 * std::numeric_limits<T>::epsilon());
+    };
+    for (T v : xs) {
+        const V x = broadcast<V>(v);
+        assert(same(vx::sin(x)[1], std::sin(v)));
+        assert(same(vx::cos(x)[1], std::cos(v)) and same(vx::tan(x)[1], std::tan(v)));
+        assert(same(vx::asin(x)[1], std::asin(v)) and same(vx::acos(x)[1], std::acos(v)));
+        assert(same(vx::atan(x)[1], std::atan(v)));
+        for (T w : xs) {
+            const T r = vx::atan2(x, broadcast<V>(w))[0], ref = std::atan2(v, w);
+            assert(same(r, ref));
+        }
+    }
+    V h = broadcast<V>((T)1e30); // scalar fallback
+    h[0] = (T)3;
+    assert(vx::sin(h)[1] == std::sin((T)1e30) and vx::cos(h)[1] == std::cos((T)1e30) and vx::tan(h)[1] == std::tan((T)1e30));
+
+    return true;
+}
+
+template <typename V>
+static bool test_activation_type()
+{
+    using namespace vx;
+    using T = typename get_base<V>::type;
+    constexpr bool f32 = std::is_same_v<T, float>;
+
+    auto phi = [](long double x) {return 0.5L * x * erfcl(-x / sqrtl(2.0L));};
+    auto sig = [](long double x) {return 1 / (1 + expl(-x));};
+    auto gtanh = [](long double x) {return x / (1 + expl(-2 * 0.797884560802865355879892L * (x + 0.044715L * x * x * x)));};
+
+    assert(max_ulp<V>([](V x) {return vx::tanh(x);}, [](long double x) {return tanhl(x);}, -10, 10) <= 3.5 + slack);
+    assert(max_ulp<V>([](V x) {return vx::tanh(x);}, [](long double x) {return tanhl(x);}, -0.5, 0.5) <= 3.5 + slack);
+    assert(max_ulp<V>([](V x) {return vx::sigmoid(x);}, sig, f32 ? -100 : -740, 40) <= 2.5 + slack);
+    assert(max_ulp<V>([](V x) {return vx::sigmoid<accuracy::fast>(x);}, sig, -80, 40) <= 4.5 + slack);
+    assert(max_ulp<V>([](V x) {return vx::silu(x);}, [](long double x) {return x / (1 + expl(-x));}, -80, 40) <= 3 + slack);
+    assert(max_ulp<V>([](V x) {return vx::silu(x);}, [](long double x) {return x / (1 + expl(-x));}, f32 ? -110 : -750, -80) <= 3 + slack);
+    assert(max_ulp<V>([](V x) {return vx::silu<accuracy::fast>(x);}, [](long double x) {return x / (1 + expl(-x));}, f32 ? -87 : -708, 40) <= 5 + slack);
+    assert(max_ulp<V>([](V x) {return vx::softplus(x);}, [](long double x) {return log1pl(expl(x));}, -80, 80) <= 2 + slack);
+    assert(max_ulp<V>([](V x) {return vx::softplus<accuracy::fast>(x);}, [](long double x) {return log1pl(expl(x));}, -80, 80) <= 6 + slack);
+    assert(max_ulp<V>([](V x) {return vx::erf(x);}, [](long double x) {return erfl(x);}, -7, 7) <= (f32 ? 2.1 : 2) + slack);
+    assert(max_ulp<V>([](V x) {return vx::erf(x);}, [](long double x) {return erfl(x);}, -1, 1) <= (f32 ? 2.1 : 2) + slack);
+    assert(max_ulp<V>([](V x) {return vx::erf<accuracy::fast>(x);}, [](long double x) {return erfl(x);}, -7, 7) <= 3 + slack);
+    assert(max_ulp<V>([](V x) {return vx::gelu(x);}, phi, -3, 3) <= 6 + slack);
+    assert(max_ulp<V>([](V x) {return vx::gelu(x);}, phi, f32 ? -15 : -39, 10) <= 6 + slack);
+    assert(max_ulp<V>([](V x) {return vx::gelu<accuracy::fast>(x);}, phi, f32 ? -13 : -37, 10) <= 8 + slack);
+    assert(max_ulp<V>([](V x) {return vx::gelu_tanh(x);}, gtanh, -2, 8) <= 10 + slack);
+
+    const T inf = std::numeric_limits<T>::infinity(), nan = std::numeric_limits<T>::quiet_NaN();
+    const T big = std::numeric_limits<T>::max();
+    const V s = {inf, -inf}, b = {big, -big};
+    assert(vx::tanh(s)[0] == 1 and vx::tanh(s)[1] == -1 and vx::tanh(b)[1] == -1);
+    assert(vx::sigmoid(s)[0] == 1 and vx::sigmoid(s)[1] == 0);
+    assert(vx::erf(s)[0] == 1 and vx::erf(s)[1] == -1 and vx::erf(b)[0] == 1);
+    assert(vx::gelu(s)[0] == inf and vx::gelu(s)[1] == 0 and std::signbit(vx::gelu(s)[1]));
+    assert(vx::gelu(b)[0] == big and vx::gelu(b)[1] == 0);
+    assert(vx::softplus(s)[0] == inf and vx::softplus(s)[1] == 0);
+    assert(vx::silu(b)[0] == big and vx::silu(b)[1] == 0 and vx::silu<accuracy::fast>(b)[1] == 0);
+    const V z = {-(T)0, nan};
+    assert(std::signbit(vx::tanh(z)[0]) and std::signbit(vx::erf(z)[0]) and std::signbit(vx::gelu(z)[0]));
+    assert(vx::sigmoid(z)[0] == (T)0.5 and vx::softplus(z)[0] == std::log((T)2));
+    assert(std::isnan(vx::tanh(z)[1]) and std::isnan(vx::sigmoid(z)[1]) and std::isnan(vx::erf(z)[1]));
+    assert(std::isnan(vx::gelu(z)[1]) and std::isnan(vx::softplus(z)[1]) and std::isnan(vx::silu(z)[1]));
+
+    return true;
+}
+
+template <typename V>
+static bool test_rcp_type()
+{
+    using namespace vx;
+    using T = typename get_base<V>::type;
+#ifdef __AVX512VL__
+    const double rcp_ulp = 1, rsqrt_ulp = 1.5;
+#else
+    constexpr bool f32 = std::is_same_v<T, float>;
+    const double rcp_ulp = f32 ? 2.5 : 0.5, rsqrt_ulp = f32 ? 3 : 1.5;
+#endif
+
+    auto inv = [](long double x) {return 1 / x;};
+    auto invsqrt = [](long double x) {return 1 / sqrtl(x);};
+    assert(max_ulp<V>([](V x) {return vx::rcp(x);}, inv, -3, 3) <= rcp_ulp + slack);
+    assert(max_ulp<V>([](V x) {return vx::rcp(x);}, inv, -100, 100, true) <= rcp_ulp + slack);
+    assert(max_ulp<V>([](V x) {return vx::rsqrt(x);}, invsqrt, 0, 4) <= rsqrt_ulp + slack);
+    assert(max_ulp<V>([](V x) {return vx::rsqrt(x);}, invsqrt, -100, 100, true) <= rsqrt_ulp + slack);
+    if constexpr (has_rcp_estimate<V>()) {
+        // raw estimate is within 1.5*2^-12, each step doubles correct bits
+        const double e0 = max_ulp<V>([](V x) {return vx::rcp<0>(x);}, inv, 0.5, 2);
+        assert(e0 > 100 and e0 < 0x1.8p-11 / std::numeric_limits<T>::epsilon());
+        assert(max_ulp<V>([](V x) {return vx::rcp<3>(x);}, inv, 0.5, 2) <= 0.5 + 2 * slack);
+        assert(max_ulp<V>([](V x) {return vx::rsqrt<3>(x);}, invsqrt, 0.5, 2) <= 1.5 + slack);
+    }
+
+    const T inf = std::numeric_limits<T>::infinity(), nan = std::numeric_limits<T>::quiet_NaN();
+    const V s = {inf, -(T)0}, z = {-inf, nan}, n = {-1, (T)0};
+    assert(vx::rcp(s)[0] == 0 and vx::rcp(s)[1] == -inf and vx::rcp(z)[0] == 0 and std::signbit(vx::rcp(z)[0]));
+    assert(std::isnan(vx::rcp(z)[1]) and vx::rcp(n)[1] == inf);
+    assert(vx::rsqrt(s)[0] == 0 and vx::rsqrt(s)[1] == -inf and vx::rsqrt(n)[1] == inf);
+    assert(std::isnan(vx::rsqrt(n)[0]) and std::isnan(vx::rsqrt(z)[0]) and std::isnan(vx::rsqrt(z)[1]));
+    assert(ulp_error<T>(vx::rcp(n)[0], -1) <= rcp_ulp + slack);
+
+    return true;
+}
+
+static bool test_poly()
+{
+    return test_poly_type<vx::F32x4>() and test_poly_type<vx::F64x2>();
+}
+
+static bool test_exp()
+{
+    return test_exp_type<vx::F32x4>() and test_exp_type<vx::F64x2>();
+}
+
+static bool test_log()
+{
+    return test_log_type<vx::F32x4>() and test_log_type<vx::F64x2>();
+}
+
+static bool test_pow()
+{
+    return test_pow_type<vx::F32x4>() and test_pow_type<vx::F64x2>();
+}
+
+template <typename V>
+static bool test_hypot_type()
+{
+    using namespace vx;
+    using T = typename get_base<V>::type;
+    const T inf = std::numeric_limits<T>::infinity(), nan = std::numeric_limits<T>::quiet_NaN();
+    const T big = std::numeric_limits<T>::max() / 2, tiny = std::numeric_limits<T>::denorm_min();
+
+    std::mt19937_64 gen(3);
+    std::uniform_real_distribution<double> e(std::numeric_limits<T>::min_exponent - 30, std::numeric_limits<T>::max_exponent - 1);
+    std::uniform_real_distribution<double> d(-20, 20);
+    double worst = 0;
+    for (int i = 0; i < 20000; ++i) {
+        V x, y;
+        for (unsigned j = 0; j < nrelem<V>(); ++j) {
+            x[j] = (T)std::ldexp(d(gen), (int)e(gen));
+            y[j] = (T)(i % 2 ? std::ldexp(d(gen), (int)e(gen)) : x[j] * d(gen));
+        }
+        const V h = vx::hypot(x, y);
+        for (unsigned j = 0; j < nrelem<V>(); ++j) {
+            worst = std::max(worst, ulp_error<T>(h[j], hypotl(x[j], y[j])));
+        }
+    }
+    assert(worst <= 1 + slack);
+
+    auto h = [](T x, T y) {return vx::hypot(broadcast<V>(x), broadcast<V>(y))[0];};
+    assert(h(3, 4) == 5 and h(-3, 4) == 5 and h(0, 0) == 0 and h(0, -2) == 2);
+    assert(h(big, big) == std::hypot(big, big) and h(tiny, tiny) == std::hypot(tiny, tiny));
+    assert(h(inf, nan) == inf and h(nan, -inf) == inf and std::isnan(h(nan, 1)) and std::isnan(h(1, nan)));
+
+    return true;
+}
+
+static bool test_hypot()
+{
+    return test_hypot_type<vx::F32x4>() and test_hypot_type<vx::F64x2>();
+}
+
+static bool test_trig()
+{
+    return test_trig_type<vx::F32x4>() and test_trig_type<vx::F64x2>();
+}
+
+static bool test_activation()
+{
+    return test_activation_type<vx::F32x4>() and test_activation_type<vx::F64x2>();
+}
+
+static bool test_rcp()
+{
+    return test_rcp_type<vx::F32x4>() and test_rcp_type<vx::F64x2>();
+}
+
+static bool test_widths()
+{
+    using namespace vx;
+
+    F32x2 a = {1, 2};
+    assert(std::fabs(vx::exp(a)[1] - 7.389056f) < 1e-6f);
+    assert(std::fabs(vx::pow(a, a)[1] - 4) < 1e-6f);
+#ifdef __AVX__
+    F32x8 b = {0, 1, 2, 3, 4, 5, 6, 7};
+    F32x8 lb = vx::log1p(b);
+    for (int i = 0; i < 8; ++i) assert(lb[i] == vx::log1p((F32x4){} + (float)i)[0]);
+    F64x4 c = {0.5, 1, 2, 3};
+    assert(vx::pow(c, c)[3] == 27);
+    F32x8 sb, cb;
+    vx::sincos(b, sb, cb);
+    for (int i = 0; i < 8; ++i) assert(sb[i] == vx::sin((F32x4){} + (float)i)[0] and cb[i] == vx::cos(b)[i]);
+#endif
+#ifdef __AVX512F__
+    F32x16 d = vx::exp2((F32x16){} + 10);
+    F64x8 e = vx::log2((F64x8){} + 1024);
+    assert(d[15] == 1024 and e[7] == 10);
+    assert(vx::pow(d, (F32x16){} + 0.5f)[3] == 32);
+    assert(vx::atan2((F64x8){} + 1, (F64x8){} - 1)[5] == vx::atan2((F64x2){} + 1, (F64x2){} - 1)[0]);
+    assert(vx::asin((F32x16){} + 1)[9] == vx::acos((F32x16){})[0]);
+#endif
+
+    return true;
+}
+
+using TestFun = bool (*)();
+
+static TestFun tests[] = {
+    test_poly, test_exp, test_log, test_pow, test_trig, test_hypot, test_activation, test_rcp, test_widths
+};
+
+int main(int, char**)
+{
+    for (auto test : tests) {
+        if (!test()) return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,90 @@
+#include <cstdlib>
+#include <cstdint>
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <span>
+
+#include "vx/vxnn.hpp"
+
+template <typename T>
+static std::vector<T> ramp(std::size_t n)
+{
+    std::vector<T> v(n);
+    for (std::size_t i = 0; i < n; ++i) { v[i] = (T)((int)((i * 37) % 101) - 50) / 8; }
+    return v;
+}
+
+// Span form must match vector function on every element, whatever the head and tail.
+template <typename T>
+static bool test_span_type()
+{
+    using namespace vx;
+    using U = std::conditional_t<std::is_same_v<T, float>, F32x4, F64x2>;
+
+    for (std::size_t n : {0, 1, 3, 17, 64, 100, 259}) {
+        for (std::size_t off : {0, 1, 5}) {
+            const auto x = ramp<T>(n + off);
+            auto check = [&](auto nn_fun, auto vec_fun) {
+                std::vector<T> y(x);
+                nn_fun(std::span<T>(y.data() + off, n));
+                for (std::size_t i = 0; i < off; ++i) { assert(y[i] == x[i]); }
+                for (std::size_t i = 0; i < n; ++i) {
+                    assert(y[i + off] == vec_fun(broadcast<U>(x[i + off]))[0]);
+                }
+            };
+            check([](std::span<T> s) {nn::tanh<T>(s);}, [](U v) {return vx::tanh(v);});
+            check([](std::span<T> s) {nn::sigmoid<T>(s);}, [](U v) {return vx::sigmoid(v);});
+            check([](std::span<T> s) {nn::gelu<T>(s);}, [](U v) {return vx::gelu(v);});
+            check([](std::span<T> s) {nn::gelu_tanh<T>(s);}, [](U v) {return vx::gelu_tanh(v);});
+            check([](std::span<T> s) {nn::erf<T>(s);}, [](U v) {return vx::erf(v);});
+            check([](std::span<T> s) {nn::softplus<T>(s);}, [](U v) {return vx::softplus(v);});
+            check([](std::span<T> s) {nn::silu<T, accuracy::fast>(s);}, [](U v) {return vx::silu<accuracy::fast>(v);});
+        }
+    }
+
+    return true;
+}
+
+static bool test_span()
+{
+    return test_span_type<float>() and test_span_type<double>();
+}
+
+static bool test_nn_array()
+{
+    using namespace vx;
+
+    vx::array<float, 21> x;
+    for (std::size_t i = 0; i < 21; ++i) x[i] = (float)i - 10;
+
+    const auto y = nn::sigmoid(x);
+    const auto g = nn::gelu<float, accuracy::fast>(x);
+    for (std::size_t i = 0; i < 21; ++i) {
+        assert(y[i] == vx::sigmoid((F32x4){} + x[i])[0]);
+        assert(g[i] == vx::gelu<accuracy::fast>((F32x4){} + x[i])[0]);
+    }
+    assert(y[10] == 0.5f and x[10] == 0);
+
+    vx::array<double, 7> z {-3, -2, -1, 0, 1, 2, 3};
+    const auto t = nn::tanh(z);
+    assert(t[3] == 0 and t[0] == -t[6] and std::fabs(t[6] - std::tanh(3.0)) < 1e-15);
+    assert(nn::softplus(z)[3] == std::log(2.0));
+
+    return true;
+}
+
+using TestFun = bool (*)();
+
+static TestFun tests[] = {
+    test_span, test_nn_array
+};
+
+int main(int, char**)
+{
+    for (auto test : tests) {
+        if (!test()) return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
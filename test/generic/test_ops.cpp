@@ -1,6 +1,7 @@
 #include <cstdlib>
 #include <cstdint>
 #include <cstring>
+#include <cmath>
 #include <cassert>
 #include <type_traits>
 
@@ -103,11 +104,269 @@ static bool test_load()
     return true;
 }
 
+static bool test_loadu()
+{
+    using namespace vx;
+
+    alignas(64) int32_t buf[17];
+    for (int i = 0; i < 17; ++i) { buf[i] = i; }
+
+    I32x4 a;
+    vx::loadu(a, &buf[1]); // unaligned
+    assert(equal(a, (I32x4){1,2,3,4}));
+    vx::load(a, &buf[4]);
+    assert(equal(a, (I32x4){4,5,6,7}));
+
+    I32x8 b;
+    vx::loadu(b, &buf[3]);
+    assert(b[0] == 3 and b[7] == 10);
+
+#ifdef __AVX512F__
+    I32x16 c;
+    vx::load(c, &buf[0]);
+    assert(c[15] == 15);
+    vx::storeu(&buf[1], c);
+    assert(buf[1] == 0 and buf[16] == 15);
+
+    alignas(64) uint8_t bytes[65];
+    U8x64 d;
+    fill_zero(d);
+    d[63] = 0xAB;
+    vx::storeu(&bytes[1], d);
+    assert(bytes[1] == 0 and bytes[64] == 0xAB);
+#endif
+
+    const uint8_t u8[16] = {1,2,250,255, 5,6,7,8, 9,10,11,12, 13,14,15,200};
+    const int8_t i8[4] = {-1,2,-128,127};
+    I32x4 w;
+    vx::loadu_widen(w, u8);
+    assert(equal(w, (I32x4){1,2,250,255}));
+    vx::loadu_widen(w, i8);
+    assert(equal(w, (I32x4){-1,2,-128,127}));
+    const uint16_t u16[8] = {1,65535,3,4,5,6,7,8};
+    vx::loadu_widen(w, u16);
+    assert(equal(w, (I32x4){1,65535,3,4}));
+    vx::loadu_widen(w, (const int16_t*)u16);
+    assert(equal(w, (I32x4){1,-1,3,4}));
+    U16x4 h;
+    vx::loadu_widen(h, u8);
+    assert(equal(h, (U16x4){1,2,250,255}));
+#ifdef __AVX2__
+    U32x8 w8;
+    vx::loadu_widen(w8, u8 + 1);
+    assert(equal(w8, (U32x8){2,250,255,5,6,7,8,9}));
+#endif
+#ifdef __AVX512F__
+    I32x16 w16;
+    vx::loadu_widen(w16, u8);
+    assert(w16[2] == 250 and w16[15] == 200);
+#endif
+
+    F32x8 e = {1,2,3,4,5,6,7,8};
+    alignas(32) float f[8];
+    vx::store(f, e);
+    assert(f[7] == 8.0f);
+
+    return true;
+}
+
+static bool test_maskload()
+{
+    using namespace vx;
+
+    static_assert(std::is_same<vx::get_mask<F32x4>::type, I32x4>::value);
+    assert(equal(mask_first_n<I32x4>(3), (I32x4){-1,-1,-1,0}));
+
+    float a[3] = {1,2,3};
+    F32x4 v;
+    vx::maskload(v, a, mask_first_n<I32x4>(3));
+    assert(equal(v, (F32x4){1,2,3,0}));
+
+    float b[3] = {0,0,0};
+    vx::maskstore(b, (F32x4){4,5,6,7}, mask_first_n<I32x4>(3));
+    assert(b[0] == 4 and b[2] == 6);
+
+    int16_t c[5] = {1,2,3,4,5};
+    I16x8 w;
+    vx::maskload(w, c, mask_first_n<I16x8>(5));
+    assert(equal(w, (I16x8){1,2,3,4,5,0,0,0}));
+
+#ifdef __AVX512F__
+    uint8_t d[40] = {0};
+    U8x64 x;
+    vx::fill_zero(x);
+    x += 9;
+    vx::maskstore(d, x, mask_first_n<I8x64>(39));
+    assert(d[38] == 9 and d[39] == 0);
+
+    double e[7] = {1,2,3,4,5,6,7};
+    F64x8 y;
+    vx::maskload(y, e, mask_first_n<I64x8>(7));
+    assert(y[6] == 7.0 and y[7] == 0.0);
+#endif
+
+    return true;
+}
+
+static bool test_gather()
+{
+    using namespace vx;
+
+    assert(movemask((I32x4){-1,0,-1,0}) == 0b0101);
+
+    double table[100];
+    for (int i = 0; i < 100; ++i) { table[i] = i * 0.5; }
+
+    F64x2 b;
+    vx::load_gather(b, table, (I64x2){8*2, 8*4}, 1); // byte offsets
+    assert(equal(b, (F64x2){1.0, 2.0}));
+    vx::gather(b, table, (I64x2){3, 5});
+    assert(equal(b, (F64x2){1.5, 2.5}));
+
+#ifdef __AVX__
+    F64x4 a;
+    vx::gather(a, table, (I32x4){7,0,99,7});
+    assert(equal(a, (F64x4){3.5, 0.0, 49.5, 3.5}));
+
+    int32_t ints[16];
+    for (int i = 0; i < 16; ++i) { ints[i] = 100 + i; }
+
+    I32x8 c = {0};
+    vx::mask_gather(c, ints, (I64x8){1,2,3,4,5,6,7,8}, mask_first_n<I32x8>(3));
+    assert(equal(c, (I32x8){101,102,103,0,0,0,0,0}));
+
+    float out[8] = {0};
+    vx::scatter(out, (I32x4){7,5,3,1}, (F32x4){1,2,3,4});
+    assert(out[7] == 1 and out[5] == 2 and out[3] == 3 and out[1] == 4);
+
+    vx::mask_scatter(out, (I64x4){0,2,4,6}, (F32x4){9,9,9,9}, (I32x4){-1,0,-1,0});
+    assert(out[0] == 9 and out[2] == 0 and out[4] == 9 and out[6] == 0);
+#endif
+
+#ifdef __AVX512F__
+    U32x16 d;
+    I32x16 idx;
+    for (int i = 0; i < 16; ++i) { idx[i] = 15 - i; }
+    vx::gather(d, (const uint32_t*)ints, idx);
+    assert(d[0] == 115 and d[15] == 100);
+
+    vx::scatter(ints, idx, (I32x16){0});
+    assert(ints[0] == 0 and ints[15] == 0);
+#endif
+
+    return true;
+}
+
+static bool test_arith()
+{
+    using namespace vx;
+
+    assert(equal(add((I32x4){1,2,3,4}, (I32x4){10,20,30,40}), (I32x4){11,22,33,44}));
+    assert(equal(sub((F32x4){1,2,3,4}, (F32x4){1,1,1,1}), (F32x4){0,1,2,3}));
+    assert(equal(mul((F64x2){1.5,2}, (F64x2){2,3}), (F64x2){3,6}));
+    assert(equal(div((F32x4){1,2,3,4}, (F32x4){2,2,2,2}), (F32x4){0.5,1,1.5,2}));
+
+    assert(equal(min((I8x16){-1,2}, (I8x16){1,-2}), (I8x16){-1,-2}));
+    assert(equal(min((U8x16){0xFF,2}, (U8x16){1,0xFE}), (U8x16){1,2}));
+    assert(equal(max((U32x4){0xFFFFFFFF,2,3,4}, (U32x4){1,5,3,0}), (U32x4){0xFFFFFFFF,5,3,4}));
+    assert(equal(max((I64x2){-5,7}, (I64x2){3,-9}), (I64x2){3,7}));
+    assert(equal(min((F64x2){-0.5,7}, (F64x2){3,-9}), (F64x2){-0.5,-9}));
+
+    assert(equal(abs((I16x8){-1,2,-32767}), (I16x8){1,2,32767}));
+    assert(equal(abs((F32x4){-1.5,2,-0.0,-4}), (F32x4){1.5,2,0.0,4}));
+    assert(equal(abs((I64x2){-3,3}), (I64x2){3,3}));
+
+    assert(equal(add_saturated((I8x16){120,-120}, (I8x16){10,-10}), (I8x16){127,-128}));
+    assert(equal(add_saturated((U16x4){65530,1}, (U16x4){10,1}), (U16x4){65535,2}));
+    assert(equal(sub_saturated((U8x16){5,5}, (U8x16){10,1}), (U8x16){0,4}));
+    assert(equal(add_saturated((I32x4){INT32_MAX,INT32_MIN,1,-1}, (I32x4){1,-1,1,-1}),
+                 (I32x4){INT32_MAX,INT32_MIN,2,-2}));
+    assert(equal(sub_saturated((I64x2){INT64_MIN,5}, (I64x2){1,7}), (I64x2){INT64_MIN,-2}));
+    assert(equal(add_saturated((U32x4){0xFFFFFFF0,1}, (U32x4){0x20,1}), (U32x4){0xFFFFFFFF,2}));
+
+    assert(equal(madd((F32x4){1,2,3,4}, (F32x4){2,2,2,2}, (F32x4){1,1,1,1}), (F32x4){3,5,7,9}));
+    assert(equal(msub((F64x2){1,2}, (F64x2){2,2}, (F64x2){1,1}), (F64x2){1,3}));
+    assert(equal(nmadd((F64x2){1,2}, (F64x2){2,2}, (F64x2){1,1}), (F64x2){-1,-3}));
+    assert(equal(madd((I32x4){1,2,3,4}, (I32x4){2,2,2,2}, (I32x4){1,1,1,1}), (I32x4){3,5,7,9}));
+    assert(equal(mulhi((U32x4){0x80000000u,7,0xFFFFFFFFu,0}, (U32x4){6,7,0xFFFFFFFFu,5}), (U32x4){3,0,0xFFFFFFFEu,0}));
+    assert(equal(mulhi((I32x4){INT32_MIN,-1,-7,3}, (I32x4){2,1,INT32_MAX,-1}), (I32x4){-1,-1,-4,-1}));
+    assert(equal(mulhi((U64x2){~0UL,1UL<<63}, (U64x2){~0UL,4}), (U64x2){~0UL-1,2}));
+    assert(equal(mulhi((I64x2){INT64_MIN,-3}, (I64x2){INT64_MIN,5}), (I64x2){1L<<62,-1}));
+    assert(equal(mulhi((U16x8){65535,1000,2,0}, (U16x8){65535,257,3,9}), (U16x8){65534,3,0,0}));
+    assert(equal(mulhi((I16x8){-32768,-1,300,7}, (I16x8){2,1,-300,9}), (I16x8){-1,-1,-2,0}));
+    assert(equal(mulhi((U16x4){60000,0,0,0}, (U16x4){60000,0,0,0}), (U16x4){54931,0,0,0}));
+    assert(equal(madd_pairs((I16x8){1,2,3,4,-5,6,INT16_MIN,INT16_MIN}, (I16x8){1,1,2,2,3,-3,INT16_MIN,1}),
+                 (I32x4){3,14,-33,(1<<30) - 32768}));
+    assert(equal(madd_pairs((I16x4){INT16_MIN,INT16_MIN,7,0}, (I16x4){INT16_MIN,INT16_MIN,-2,0}), (I32x2){INT32_MIN,-14}));
+    assert(equal(round_to_int((F32x4){0.5f,1.5f,-2.6f,7}), (I32x4){0,2,-3,7}));
+    assert(equal(round_to_int((F32x4){3e9f,-3e9f,-2.5f,NAN}), (I32x4){INT32_MIN,INT32_MIN,-2,INT32_MIN}));
+
+#ifdef __AVX__
+    assert(equal(add((F32x8){1,2,3,4,5,6,7,8}, (F32x8){1,1,1,1,1,1,1,1}), (F32x8){2,3,4,5,6,7,8,9}));
+    assert(equal(mul((I64x4){1,-2,3,1L<<40}, (I64x4){3,3,3,2}), (I64x4){3,-6,9,1L<<41}));
+    assert(equal(max((I16x16){-1,5}, (I16x16){1,-5}), (I16x16){1,5}));
+    assert(equal(round_to_int((F32x8){} + 2.5f), (I32x8){} + 2));
+#endif
+#ifdef __AVX512F__
+    F32x16 a;
+    fill(a, -2.5f);
+    assert(equal(abs(a), add(a, (F32x16){} + 5.0f)));
+    I8x64 b;
+    fill(b, 100);
+    assert(equal(add_saturated(b, b), (I8x64){} + 127));
+    assert(equal(madd((F64x8){} + 2, (F64x8){} + 3, (F64x8){} + 1), (F64x8){} + 7));
+    assert(equal(madd_pairs((I16x32){} + 300, (I16x32){} - 2), (I32x16){} - 1200));
+    assert(equal(mulhi((U16x32){} + 40000, (U16x32){} + 50000), (U16x32){} + 30517));
+#endif
+
+    return true;
+}
+
+static bool test_kmask()
+{
+    using namespace vx;
+
+    auto m = compare<cmp::lt>((F32x4){1,5,2,6}, (F32x4){3,3,3,3});
+    static_assert(std::is_same<decltype(m), kmask<4>>::value);
+    assert(m.bits == 0b0101);
+    assert(any(m) and !all(m) and !none(m));
+    assert(popcount(m) == 2 and first_set(m) == 0);
+    assert(all(m | ~m) and none(m & ~m));
+
+    assert(compare<cmp::ge>((U8x16){200,1}, (U8x16){100,2}).bits == 0b1111'1111'1111'1101);
+    assert(compare<cmp::ne>((I64x2){1,2}, (I64x2){1,3}).bits == 0b10);
+
+    I32x4 src{0,0,0,0};
+    assert(equal(add(m, src, (I32x4){1,2,3,4}, (I32x4){10,20,30,40}), (I32x4){11,0,33,0}));
+    assert(equal(blend(~m, src, (I32x4){1,2,3,4}), (I32x4){0,2,0,4}));
+
+#ifdef __AVX512F__
+    F64x8 a{1,2,3,4,5,6,7,8};
+    auto k = compare<cmp::gt>(a, (F64x8){} + 4);
+    assert(k.bits == 0b1111'0000 and first_set(k) == 4);
+
+    F64x8 b = mul(k, a, a, (F64x8){} + 2);
+    assert(equal(b, (F64x8){1,2,3,4,10,12,14,16}));
+
+    I8x64 c;
+    fill(c, 3);
+    c[63] = 5;
+    auto k64 = compare<cmp::eq>(c, (I8x64){} + 3);
+    static_assert(std::is_same<decltype(k64.bits), __mmask64>::value);
+    assert(popcount(k64) == 63 and !all(k64));
+
+    assert(equal(a, a) and !equal(a, b));
+#endif
+
+    return true;
+}
+
 using TestFun = bool (*)();
 
 static TestFun tests[] = {
     test_ops1, test_ops2, test_logic,
-    test_shuffle, test_load
+    test_shuffle, test_load, test_loadu, test_maskload,
+    test_gather, test_arith, test_kmask
 };
 
 int main(int, char**)
@@ -0,0 +1,49 @@
+/**@file
+ * @brief     Seeded random test data shared by tests.
+ */
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+/// `n` values uniform in `[lo, hi]`, reproducible for a seeded `gen`.
+template <typename T>
+std::vector<T> random_values(std::size_t n, std::mt19937& gen, T lo, T hi)
+{
+    std::vector<T> v(n);
+    if constexpr (std::is_floating_point_v<T>) {
+        std::uniform_real_distribution<T> dist(lo, hi);
+        for (auto& x : v) x = dist(gen);
+    }
+    else {
+        using D = std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>;
+        std::uniform_int_distribution<D> dist(lo, hi);
+        for (auto& x : v) x = (T)dist(gen);
+    }
+    return v;
+}
+
+template <typename T>
+inline constexpr bool is_complex_v = false;
+template <typename T>
+inline constexpr bool is_complex_v<std::complex<T>> = true;
+
+/// `n` values in `[-1, 1]` for floating point `T` (both parts for `std::complex`),
+/// any value of integer `T`.
+template <typename T>
+std::vector<T> random_values(std::size_t n, std::mt19937& gen)
+{
+    if constexpr (is_complex_v<T>) {
+        using R = typename T::value_type;
+        std::uniform_real_distribution<R> dist(-1, 1);
+        std::vector<T> v(n);
+        for (auto& x : v) x = {dist(gen), dist(gen)};
+        return v;
+    }
+    else if constexpr (std::is_floating_point_v<T>) return random_values<T>(n, gen, -1, 1);
+    else return random_values<T>(n, gen, std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
+}
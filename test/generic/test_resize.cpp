@@ -0,0 +1,122 @@
+#include <cstdlib>
+#include <cstdint>
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "vx/vxresize.hpp"
+#include "test_random.hpp"
+
+using namespace vx;
+using image::resize_filter;
+
+static double kernel(resize_filter f, double x)
+{
+    x = std::abs(x);
+    if (f == resize_filter::bilinear) return std::max(0.0, 1 - x);
+    if (x < 1) return (1.5*x - 2.5)*x*x + 1;
+    if (x < 2) return ((-0.5*x + 2.5)*x - 4)*x + 2;
+    return 0;
+}
+
+// Resampled element in double from all taps around the source coordinate, edges replicated.
+template <typename T>
+static double ideal(const std::vector<T>& src, std::size_t stride, std::size_t sw, std::size_t sh, std::size_t ch,
+    std::size_t dw, std::size_t dh, std::size_t x, std::size_t y, std::size_t c, resize_filter f)
+{
+    const double sx = (x + 0.5) * sw / dw - 0.5, sy = (y + 0.5) * sh / dh - 0.5;
+    const std::ptrdiff_t r = f == resize_filter::bicubic ? 2 : 1;
+    double acc = 0;
+    for (std::ptrdiff_t i = std::floor(sy) - r + 1; i <= std::floor(sy) + r; ++i) {
+        for (std::ptrdiff_t j = std::floor(sx) - r + 1; j <= std::floor(sx) + r; ++j) {
+            const std::ptrdiff_t ci = std::clamp(i, (std::ptrdiff_t)0, (std::ptrdiff_t)sh - 1);
+            const std::ptrdiff_t cj = std::clamp(j, (std::ptrdiff_t)0, (std::ptrdiff_t)sw - 1);
+            acc += kernel(f, sy - i) * kernel(f, sx - j) * src[ci*stride + cj*ch + c];
+        }
+    }
+    return acc;
+}
+
+// Source and destination sizes: up, down, mixed, tiny and one pixel.
+static constexpr std::size_t sizes[][4] = {
+    {37, 23, 80, 50}, {80, 50, 37, 23}, {64, 9, 17, 30}, {3, 2, 40, 7}, {1, 1, 5, 3}, {100, 4, 1, 1}};
+
+template <typename T>
+static void check_resize(std::mt19937& gen)
+{
+    for (const auto& [sw, sh, dw, dh] : sizes) {
+        for (std::size_t ch : {1, 4}) {
+            for (resize_filter f : {resize_filter::bilinear, resize_filter::bicubic}) {
+                const std::size_t ss = sw*ch + 5, ds = dw*ch + 3;
+                const auto src = random_values<T>(ss * sh, gen);
+                std::vector<T> dst(ds * dh, 7);
+                image::resize<T>(src.data(), ss, sw, sh, dst.data(), ds, dw, dh, ch, f);
+                for (std::size_t y = 0; y < dh; ++y) {
+                    for (std::size_t x = 0; x < dw; ++x) {
+                        for (std::size_t c = 0; c < ch; ++c) {
+                            const double e = ideal(src, ss, sw, sh, ch, dw, dh, x, y, c, f);
+                            const T v = dst[y*ds + x*ch + c];
+                            if constexpr (std::is_same_v<T, float>) assert(std::abs(v - e) <= 1e-5);
+                            else assert(std::abs(v - std::clamp(e, 0.0, 255.0)) <= 1.0);
+                        }
+                    }
+                    for (std::size_t i = dw*ch; i < ds; ++i) assert(dst[y*ds + i] == 7);
+                }
+
+                // strips on threads give the same image
+                std::vector<T> par(dst.size(), 7);
+                image::resize<T>(src.data(), ss, sw, sh, par.data(), ds, dw, dh, ch, f, 3);
+                assert(par == dst);
+            }
+        }
+    }
+}
+
+static bool test_resize()
+{
+    std::mt19937 gen(1);
+    check_resize<uint8_t>(gen);
+    check_resize<float>(gen);
+    return true;
+}
+
+static bool test_exact()
+{
+    // same size and flat images are kept exactly
+    std::mt19937 gen(2);
+    for (resize_filter f : {resize_filter::bilinear, resize_filter::bicubic}) {
+        const auto src = random_values<uint8_t>(45*4*20, gen);
+        std::vector<uint8_t> dst(src.size());
+        image::resize<uint8_t>(src.data(), 45*4, 45, 20, dst.data(), 45*4, 45, 20, 4, f);
+        assert(dst == src);
+
+        const std::vector<uint8_t> flat(31*13, 200);
+        std::vector<uint8_t> out(57*29);
+        image::resize<uint8_t>(flat.data(), 31, 31, 13, out.data(), 57, 57, 29, 1, f, 2);
+        assert(std::all_of(out.begin(), out.end(), [](uint8_t v) {return v == 200;}));
+    }
+
+    // 2x bilinear upscale of a row, pixel centers aligned
+    const float row[] = {0, 4};
+    float up[4];
+    image::resize<float>(row, 2, 2, 1, up, 4, 4, 1);
+    assert(up[0] == 0 and up[1] == 1 and up[2] == 3 and up[3] == 4);
+    return true;
+}
+
+using TestFun = bool (*)();
+
+static TestFun tests[] = {
+    test_resize, test_exact
+};
+
+int main(int, char**)
+{
+    for (auto test : tests) {
+        if (!test()) return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -3,7 +3,7 @@
 #include <cstdio>
 #include <cstring>
 
-#include "vx/vxmatrix.hpp"
+#include "vx/x86/vxmatrix.hpp"
 
 static bool test_add2()
 {
@@ -64,6 +64,16 @@ static bool test_mul2()
             assert(md.at(col,row) == mc.at(col,row));
         }
     }
+
+    vx::mx::Matrix<double> me(3, 3);
+
+    vx::mx::mulBy<2, 1>(me, ma, mb); // prefetch 1 row ahead
+
+    for (unsigned col = 0; col < 3; ++col) {
+        for (unsigned row = 0; row < 3; ++row) {
+            assert(me.at(col,row) == mc.at(col,row));
+        }
+    }
 #endif
     return true;
 }
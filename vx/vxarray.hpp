@@ -11,6 +11,7 @@
 #include <stdexcept>
 #include <iterator>
 #include <functional>
+#include <span>
 
 #include "vx/vxtypes.hpp"
 #include "vx/vxops.hpp"
@@ -56,6 +57,11 @@ public:
     array& operator=(const array&) = default;
 
     pv_array& data() {return pv;}
+    const pv_array& data() const {return pv;}
+
+    /// Returns elements as contiguous span of base-type elements.
+    std::span<T, Sz> elements() {return std::span<T, Sz>(reinterpret_cast<T*>(pv), Sz);}
+    std::span<const T, Sz> elements() const {return std::span<const T, Sz>(reinterpret_cast<const T*>(pv), Sz);}
 
     /// Returns reference to n-th element.
     reference operator[](std::size_t pos) {
@@ -116,6 +122,29 @@ public:
         }
     }
 
+    /// Returns sum of all elements.
+    ///
+    /// Summation `S` selects plain or compensated (Kahan/Neumaier) accumulation,
+    /// see `vx::summation`.
+    ///
+    /// ```c++
+    /// vx::array<double, 1000> a;
+    /// double s = a.sum<vx::summation::neumaier>();
+    /// ```
+    template <summation S = summation::plain>
+    T sum() const {
+        accumulator<S, pv_type> acc;
+        for (std::size_t chunk = 0; chunk + 1 < Cnt; ++chunk) {
+            acc.add(pv[chunk]);
+        }
+        pv_type last = pv[Cnt - 1];
+        for (std::size_t i = Sz % PSz; i != 0 and i < PSz; ++i) {
+            last[i] = 0; // last chunk is not full, skip unused elements
+        }
+        acc.add(last);
+        return acc.result();
+    }
+
     void foreach_chunk(std::function<void(pv_type&)> fun) {
         for (std::size_t chunk = 0; chunk < Cnt; ++chunk) {
             fun(pv[chunk]);
@@ -0,0 +1,368 @@
+/**@file
+ * @brief     Audio sample format conversion, channel (de)interleaving and mixing.
+ * @author    Igor Lesik 2021
+ * @copyright Igor Lesik 2021
+ *
+ * Float samples are full scale at ±1.0, integer samples at their range:
+ * `I16 / 2^15`, `I24 / 2^23`, `I32 / 2^31`. Conversions to integers round
+ * to nearest (ties to even) and saturate.
+ *
+ * Kernels work on vectors of `N = nrelem<native<float>>()` samples:
+ * integer samples are loaded as `N`-lane integer vectors and widened,
+ * results are narrowed back, tails use masked load/store.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "vx/vxtypes.hpp"
+#include "vx/vxops.hpp"
+#include "vx/vxfun.hpp"
+
+namespace vx::audio {
+
+/// Packed 24-bit little endian sample.
+struct int24
+{
+    uint8_t bytes[3];
+};
+static_assert(sizeof(int24) == 3);
+
+namespace detail {
+
+using F = native<float>;
+constexpr std::size_t N = nrelem<F>();
+
+/// `N` lanes of `T`, same number of samples as `F`.
+template <typename T>
+using lanes = typename make<T, N>::type;
+
+/// Full scale of integer sample type, 1 for float.
+template <typename T>
+constexpr float full_scale()
+{
+    if constexpr (std::is_same_v<T, float>) return 1.0f;
+    else return (float)(1ULL << (8 * sizeof(T) - 1));
+}
+
+/// Loads first `k` of `N` samples (all when `k == N`) and converts them to float, not scaled.
+template <typename T>
+F load(const T* p, std::size_t k = N)
+{
+    using A = lanes<T>;
+    A a{};
+    if (k == N) loadu(a, p);
+    else maskload(a, p, mask_first_n<typename get_mask<A>::type>(k));
+    if constexpr (std::is_same_v<T, float>) return a;
+    else return __builtin_convertvector(a, F);
+}
+
+/// Rounds and saturates `y` (in units of `T`) and stores first `k` of `N` samples.
+template <typename T>
+void store(T* p, const F y, std::size_t k = N)
+{
+    using A = lanes<T>;
+    A a;
+    if constexpr (std::is_same_v<T, float>) {
+        a = y;
+    }
+    else if constexpr (std::is_same_v<T, int16_t>) {
+        const F c = min(max(y, broadcast<F>(INT16_MIN)), broadcast<F>(INT16_MAX));
+        a = __builtin_convertvector(round_to_int(c), A);
+    }
+    else {
+        static_assert(std::is_same_v<T, int32_t>);
+        // cvtps2dq gives INT32_MIN for out of range, fix the positive side
+        a = y >= broadcast<F>(2147483648.0f) ? broadcast<A>(INT32_MAX) : round_to_int(y);
+    }
+    if (k == N) storeu(p, a);
+    else maskstore(p, a, mask_first_n<typename get_mask<A>::type>(k));
+}
+
+/// `y[i] = f(x[i])` on vectors of `N` samples converted to float.
+template <typename In, typename Out, typename Fn>
+void transform(const In* x, Out* y, std::size_t n, Fn f)
+{
+    std::size_t i = 0;
+    for (; i + N <= n; i += N) {
+        store(y + i, f(load(x + i)));
+    }
+    if (i < n) {
+        store(y + i, f(load(x + i, n - i)), n - i);
+    }
+}
+
+/// Sign extended 24-bit samples of 12 bytes in 32-bit lanes.
+inline I32x4 unpack24(const U8x16 b)
+{
+    // sample bytes to lane bytes 1..3, arithmetic shift sign extends
+    constexpr U8x16 idx = {0,0,1,2, 3,3,4,5, 6,6,7,8, 9,9,10,11};
+    return (I32x4)__builtin_shuffle(b, idx) >> 8;
+}
+
+/// Low 3 bytes of 32-bit lanes packed to the first 12 bytes.
+inline U8x16 pack24(const I32x4 v)
+{
+    constexpr U8x16 idx = {0,1,2, 4,5,6, 8,9,10, 12,13,14, 15,15,15,15};
+    return __builtin_shuffle((U8x16)v, idx);
+}
+
+} // namespace detail
+
+/// Converts I16 samples to float, `out = in * gain / 2^15`.
+inline void to_float(std::span<const int16_t> in, std::span<float> out, float gain = 1)
+{
+    assert(in.size() == out.size());
+    const detail::F s = broadcast<detail::F>(gain / detail::full_scale<int16_t>());
+    detail::transform(in.data(), out.data(), in.size(), [&](detail::F x) {return x * s;});
+}
+
+/// Converts I32 samples to float, `out = in * gain / 2^31`.
+inline void to_float(std::span<const int32_t> in, std::span<float> out, float gain = 1)
+{
+    assert(in.size() == out.size());
+    const detail::F s = broadcast<detail::F>(gain / detail::full_scale<int32_t>());
+    detail::transform(in.data(), out.data(), in.size(), [&](detail::F x) {return x * s;});
+}
+
+/// Converts packed I24 samples to float, `out = in * gain / 2^23`.
+///
+/// Four samples per `pshufb` byte shuffle.
+inline void to_float(std::span<const int24> in, std::span<float> out, float gain = 1)
+{
+    assert(in.size() == out.size());
+    const F32x4 s = broadcast<F32x4>(gain / (float)(1 << 23));
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(in.data());
+    const std::size_t n = in.size();
+    std::size_t i = 0;
+    // 16-byte load reads 4 bytes of the next group
+    for (; i + 4 <= n and 3*i + 16 <= 3*n; i += 4) {
+        U8x16 b;
+        loadu(b, p + 3*i);
+        storeu(out.data() + i, __builtin_convertvector(detail::unpack24(b), F32x4) * s);
+    }
+    for (; i < n; i += 4) {
+        const std::size_t k = std::min<std::size_t>(4, n - i);
+        U8x16 b{};
+        std::memcpy(&b, p + 3*i, 3*k);
+        const F32x4 y = __builtin_convertvector(detail::unpack24(b), F32x4) * s;
+        maskstore(out.data() + i, y, mask_first_n<I32x4>(k));
+    }
+}
+
+/// Converts float samples to I16, `out = sat(round(in * gain * 2^15))`.
+inline void from_float(std::span<const float> in, std::span<int16_t> out, float gain = 1)
+{
+    assert(in.size() == out.size());
+    const detail::F s = broadcast<detail::F>(gain * detail::full_scale<int16_t>());
+    detail::transform(in.data(), out.data(), in.size(), [&](detail::F x) {return x * s;});
+}
+
+/// Converts float samples to I32, `out = sat(round(in * gain * 2^31))`, NaN gives `INT32_MIN`.
+inline void from_float(std::span<const float> in, std::span<int32_t> out, float gain = 1)
+{
+    assert(in.size() == out.size());
+    const detail::F s = broadcast<detail::F>(gain * detail::full_scale<int32_t>());
+    detail::transform(in.data(), out.data(), in.size(), [&](detail::F x) {return x * s;});
+}
+
+/// Converts float samples to packed I24, `out = sat(round(in * gain * 2^23))`.
+inline void from_float(std::span<const float> in, std::span<int24> out, float gain = 1)
+{
+    assert(in.size() == out.size());
+    const F32x4 s = broadcast<F32x4>(gain * (float)(1 << 23));
+    const F32x4 lo = broadcast<F32x4>(-(float)(1 << 23)), hi = broadcast<F32x4>((float)((1 << 23) - 1));
+    uint8_t* p = reinterpret_cast<uint8_t*>(out.data());
+    const std::size_t n = in.size();
+    const auto pack = [&](F32x4 x) {return detail::pack24(round_to_int(min(max(x * s, lo), hi)));};
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        F32x4 x;
+        loadu(x, in.data() + i);
+        const U8x16 b = pack(x);
+        std::memcpy(p + 3*i, &b, 12);
+    }
+    if (i < n) {
+        F32x4 x{};
+        maskload(x, in.data() + i, mask_first_n<I32x4>(n - i));
+        const U8x16 b = pack(x);
+        std::memcpy(p + 3*i, &b, 3*(n - i));
+    }
+}
+
+/// Splits interleaved frames `in[f*channels + c]` into planar channels `out[c*frames + f]`.
+///
+/// Stereo is one pair of two-source shuffles per vector. Other channel counts
+/// load up to `N` channels of `N` frames with masked loads and transpose
+/// the tile in registers.
+template <typename T>
+void deinterleave(std::span<const T> in, std::span<T> out, std::size_t channels)
+{
+    using V = native<T>;
+    using M = typename get_mask<V>::type;
+    constexpr std::size_t L = nrelem<V>();
+    assert(channels > 0 and in.size() == out.size() and in.size() % channels == 0);
+    const std::size_t C = channels, frames = in.size() / C;
+    const T* x = in.data();
+    T* y = out.data();
+
+    if (C == 1) {
+        std::copy(in.begin(), in.end(), out.begin());
+    }
+    else if (C == 2) {
+        std::size_t f = 0;
+        for (; f + L <= frames; f += L) {
+            V lo, hi, a, b;
+            loadu(lo, x + 2*f);
+            loadu(hi, x + 2*f + L);
+            deinterleave2(lo, hi, a, b);
+            storeu(y + f, a);
+            storeu(y + frames + f, b);
+        }
+        if (f < frames) {
+            const std::size_t rest = frames - f;
+            V lo{}, hi{}, a, b;
+            maskload(lo, x + 2*f, mask_first_n<M>(std::min(2*rest, L)));
+            if (2*rest > L) maskload(hi, x + 2*f + L, mask_first_n<M>(2*rest - L));
+            deinterleave2(lo, hi, a, b);
+            maskstore(y + f, a, mask_first_n<M>(rest));
+            maskstore(y + frames + f, b, mask_first_n<M>(rest));
+        }
+    }
+    else {
+        V r[L];
+        for (std::size_t g = 0; g < C; g += L) {
+            const std::size_t lanes = std::min(L, C - g);
+            const M lm = mask_first_n<M>(lanes);
+            for (std::size_t f = 0; f < frames; f += L) {
+                const std::size_t cnt = std::min(L, frames - f);
+                for (std::size_t t = 0; t < L; ++t) {
+                    r[t] = V{};
+                    if (t < cnt) maskload(r[t], x + (f + t)*C + g, lm);
+                }
+                transpose(r);
+                for (std::size_t l = 0; l < lanes; ++l) {
+                    if (cnt == L) storeu(y + (g + l)*frames + f, r[l]);
+                    else maskstore(y + (g + l)*frames + f, r[l], mask_first_n<M>(cnt));
+                }
+            }
+        }
+    }
+}
+
+/// Merges planar channels `in[c*frames + f]` into interleaved frames `out[f*channels + c]`,
+/// inverse of `deinterleave`.
+template <typename T>
+void interleave(std::span<const T> in, std::span<T> out, std::size_t channels)
+{
+    using V = native<T>;
+    using M = typename get_mask<V>::type;
+    constexpr std::size_t L = nrelem<V>();
+    assert(channels > 0 and in.size() == out.size() and in.size() % channels == 0);
+    const std::size_t C = channels, frames = in.size() / C;
+    const T* x = in.data();
+    T* y = out.data();
+
+    if (C == 1) {
+        std::copy(in.begin(), in.end(), out.begin());
+    }
+    else if (C == 2) {
+        std::size_t f = 0;
+        for (; f + L <= frames; f += L) {
+            V a, b, lo, hi;
+            loadu(a, x + f);
+            loadu(b, x + frames + f);
+            interleave2(a, b, lo, hi);
+            storeu(y + 2*f, lo);
+            storeu(y + 2*f + L, hi);
+        }
+        if (f < frames) {
+            const std::size_t rest = frames - f;
+            V a{}, b{}, lo, hi;
+            maskload(a, x + f, mask_first_n<M>(rest));
+            maskload(b, x + frames + f, mask_first_n<M>(rest));
+            interleave2(a, b, lo, hi);
+            maskstore(y + 2*f, lo, mask_first_n<M>(std::min(2*rest, L)));
+            if (2*rest > L) maskstore(y + 2*f + L, hi, mask_first_n<M>(2*rest - L));
+        }
+    }
+    else {
+        V r[L];
+        for (std::size_t g = 0; g < C; g += L) {
+            const std::size_t lanes = std::min(L, C - g);
+            const M lm = mask_first_n<M>(lanes);
+            for (std::size_t f = 0; f < frames; f += L) {
+                const std::size_t cnt = std::min(L, frames - f);
+                const M fm = mask_first_n<M>(cnt);
+                for (std::size_t l = 0; l < L; ++l) {
+                    r[l] = V{};
+                    if (l < lanes) maskload(r[l], x + (g + l)*frames + f, fm);
+                }
+                transpose(r);
+                for (std::size_t t = 0; t < cnt; ++t) maskstore(y + (f + t)*C + g, r[t], lm);
+            }
+        }
+    }
+}
+
+/// Mixes `in.size()` streams, `out[i] = sat(∑ gain[m] * in[m][i])`, every stream
+/// has `out.size()` samples. Streams and output are I16 or float.
+///
+/// Sums are accumulated in float with FMA and saturated once, at the output:
+/// I16 to its range, float to ±1.0. A tile of output vectors stays in registers
+/// while the loop over streams runs, so every input sample is loaded once.
+///
+/// Example:
+/// ```c++
+/// std::vector<const int16_t*> streams = ...;
+/// std::vector<float> gains(streams.size(), 0.25f);
+/// vx::audio::mix<int16_t, int16_t>(streams, gains, out);
+/// ```
+template <typename In, typename Out>
+void mix(std::span<const In* const> in, std::span<const float> gain, std::span<Out> out)
+{
+    static_assert(std::is_same_v<In, int16_t> or std::is_same_v<In, float>);
+    static_assert(std::is_same_v<Out, int16_t> or std::is_same_v<Out, float>);
+    using detail::F;
+    using detail::N;
+    constexpr std::size_t R = 4;
+    assert(in.size() == gain.size());
+    const std::size_t M = in.size(), n = out.size();
+
+    // scale to output units
+    std::vector<float> g(M);
+    for (std::size_t m = 0; m < M; ++m) {
+        g[m] = gain[m] * detail::full_scale<Out>() / detail::full_scale<In>();
+    }
+    const auto saturate = [](F y) {
+        if constexpr (std::is_same_v<Out, float>) return min(max(y, broadcast<F>(-1.0f)), broadcast<F>(1.0f));
+        else return y; // store saturates
+    };
+
+    std::size_t i = 0;
+    for (; i + R*N <= n; i += R*N) {
+        F acc[R] = {};
+        for (std::size_t m = 0; m < M; ++m) {
+            const F gm = broadcast<F>(g[m]);
+            vx::unroll<R>([&](std::size_t r) {acc[r] = madd(detail::load(in[m] + i + r*N), gm, acc[r]);});
+        }
+        vx::unroll<R>([&](std::size_t r) {detail::store(out.data() + i + r*N, saturate(acc[r]));});
+    }
+    for (; i < n; i += N) {
+        const std::size_t k = std::min(N, n - i);
+        F acc{};
+        for (std::size_t m = 0; m < M; ++m) {
+            acc = madd(detail::load(in[m] + i, k), broadcast<F>(g[m]), acc);
+        }
+        detail::store(out.data() + i, saturate(acc), k);
+    }
+}
+
+} // namespace vx::audio
@@ -0,0 +1,419 @@
+/**@file
+ * @brief     BLAS level-1 kernels.
+ * @author    Igor Lesik 2021
+ * @copyright Igor Lesik 2021
+ *
+ * Kernels work on `std::span` of F32/F64 elements and on `vx::array`.
+ * Loops use the widest enabled vector `vx::native<T>`:
+ * masked head until the output (or first input) is aligned,
+ * aligned main loop unrolled by 4 with independent FMA accumulators
+ * to hide FMA latency, and masked tail.
+ */
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+
+#include "vx/vxtypes.hpp"
+#include "vx/vxops.hpp"
+#include "vx/vxfun.hpp"
+#include "vx/vxarray.hpp"
+
+namespace vx::blas {
+
+/// Number of elements to process with masked load before `p` is aligned to vector `V`.
+template <typename V>
+std::size_t aligned_head(const typename get_base<V>::type* p, std::size_t n)
+{
+    using T = typename get_base<V>::type;
+    constexpr std::size_t N = nrelem<V>();
+    const std::size_t mis = (reinterpret_cast<std::uintptr_t>(p) / sizeof(T)) % N;
+    return mis ? std::min(N - mis, n) : 0;
+}
+
+/// Dot product `∑ x[i]*y[i]`.
+///
+/// Summation `S` selects plain or compensated (Kahan/Neumaier) accumulation,
+/// see `vx::summation`.
+///
+/// Example:
+/// ```c++
+/// std::vector<float> x(n, 1.0f), y(n, 2.0f);
+/// float d = vx::blas::dot<float>(x, y); // 2*n
+/// double e = vx::blas::dot<double, vx::summation::neumaier>(a, b);
+/// ```
+template <typename T, summation S = summation::plain>
+T dot(std::span<const T> x, std::span<const T> y)
+{
+    assert(x.size() == y.size());
+    using V = native<T>;
+    using M = typename get_mask<V>::type;
+    constexpr std::size_t N = nrelem<V>();
+    const T* px = x.data();
+    const T* py = y.data();
+    const std::size_t n = x.size();
+
+    accumulator<S, V> acc0, acc1, acc2, acc3;
+    V a, b;
+    std::size_t i = aligned_head<V>(px, n);
+    if (i) {
+        const M m = mask_first_n<M>(i);
+        maskload(a, px, m); maskload(b, py, m);
+        acc0.add_product(a, b);
+    }
+    for (; i + 4*N <= n; i += 4*N) {
+        V a1, a2, a3, b1, b2, b3;
+        load(a,  px + i);       loadu(b,  py + i);
+        load(a1, px + i + N);   loadu(b1, py + i + N);
+        load(a2, px + i + 2*N); loadu(b2, py + i + 2*N);
+        load(a3, px + i + 3*N); loadu(b3, py + i + 3*N);
+        acc0.add_product(a, b);
+        acc1.add_product(a1, b1);
+        acc2.add_product(a2, b2);
+        acc3.add_product(a3, b3);
+    }
+    for (; i + N <= n; i += N) {
+        load(a, px + i); loadu(b, py + i);
+        acc0.add_product(a, b);
+    }
+    if (i < n) {
+        const M m = mask_first_n<M>(n - i);
+        maskload(a, px + i, m); maskload(b, py + i, m);
+        acc1.add_product(a, b);
+    }
+    acc0.merge(acc1); acc2.merge(acc3); acc0.merge(acc2);
+    return acc0.result();
+}
+
+/// Computes `y = a*x + y`.
+template <typename T>
+void axpy(const T a, std::span<const T> x, std::span<T> y)
+{
+    assert(x.size() == y.size());
+    using V = native<T>;
+    using M = typename get_mask<V>::type;
+    constexpr std::size_t N = nrelem<V>();
+    const T* px = x.data();
+    T* py = y.data();
+    const std::size_t n = x.size();
+    V va; fill(va, a);
+
+    V vx, vy;
+    std::size_t i = aligned_head<V>(py, n);
+    if (i) {
+        const M m = mask_first_n<M>(i);
+        maskload(vx, px, m); maskload(vy, py, m);
+        maskstore(py, madd(va, vx, vy), m);
+    }
+    for (; i + 4*N <= n; i += 4*N) {
+        V vx1, vx2, vx3, vy1, vy2, vy3;
+        loadu(vx,  px + i);       load(vy,  py + i);
+        loadu(vx1, px + i + N);   load(vy1, py + i + N);
+        loadu(vx2, px + i + 2*N); load(vy2, py + i + 2*N);
+        loadu(vx3, px + i + 3*N); load(vy3, py + i + 3*N);
+        store(py + i,       madd(va, vx,  vy));
+        store(py + i + N,   madd(va, vx1, vy1));
+        store(py + i + 2*N, madd(va, vx2, vy2));
+        store(py + i + 3*N, madd(va, vx3, vy3));
+    }
+    for (; i + N <= n; i += N) {
+        loadu(vx, px + i); load(vy, py + i);
+        store(py + i, madd(va, vx, vy));
+    }
+    if (i < n) {
+        const M m = mask_first_n<M>(n - i);
+        maskload(vx, px + i, m); maskload(vy, py + i, m);
+        maskstore(py + i, madd(va, vx, vy), m);
+    }
+}
+
+/// Computes `x = a*x`.
+template <typename T>
+void scal(const T a, std::span<T> x)
+{
+    using V = native<T>;
+    using M = typename get_mask<V>::type;
+    constexpr std::size_t N = nrelem<V>();
+    T* px = x.data();
+    const std::size_t n = x.size();
+    V va; fill(va, a);
+
+    V v;
+    std::size_t i = aligned_head<V>(px, n);
+    if (i) {
+        const M m = mask_first_n<M>(i);
+        maskload(v, px, m);
+        maskstore(px, va * v, m);
+    }
+    for (; i + 4*N <= n; i += 4*N) {
+        V v1, v2, v3;
+        load(v, px + i); load(v1, px + i + N); load(v2, px + i + 2*N); load(v3, px + i + 3*N);
+        store(px + i, va * v); store(px + i + N, va * v1); store(px + i + 2*N, va * v2); store(px + i + 3*N, va * v3);
+    }
+    for (; i + N <= n; i += N) {
+        load(v, px + i);
+        store(px + i, va * v);
+    }
+    if (i < n) {
+        const M m = mask_first_n<M>(n - i);
+        maskload(v, px + i, m);
+        maskstore(px + i, va * v, m);
+    }
+}
+
+/// Applies `f` to vectors of `x` and adds results to accumulators:
+/// masked head (masked-off lanes are 0), aligned body unrolled by 4, masked tail.
+template <typename T, summation S, typename F>
+T accumulate(std::span<const T> x, F f)
+{
+    using V = native<T>;
+    using M = typename get_mask<V>::type;
+    constexpr std::size_t N = nrelem<V>();
+    const T* px = x.data();
+    const std::size_t n = x.size();
+
+    accumulator<S, V> acc0, acc1, acc2, acc3;
+    V v;
+    std::size_t i = aligned_head<V>(px, n);
+    if (i) {
+        maskload(v, px, mask_first_n<M>(i));
+        acc0.add(f(v));
+    }
+    for (; i + 4*N <= n; i += 4*N) {
+        V v1, v2, v3;
+        load(v, px + i); load(v1, px + i + N); load(v2, px + i + 2*N); load(v3, px + i + 3*N);
+        acc0.add(f(v)); acc1.add(f(v1)); acc2.add(f(v2)); acc3.add(f(v3));
+    }
+    for (; i + N <= n; i += N) {
+        load(v, px + i);
+        acc0.add(f(v));
+    }
+    if (i < n) {
+        maskload(v, px + i, mask_first_n<M>(n - i));
+        acc1.add(f(v));
+    }
+    acc0.merge(acc1); acc2.merge(acc3); acc0.merge(acc2);
+    return acc0.result();
+}
+
+/// Sum of elements `∑ x[i]`.
+///
+/// Example:
+/// ```c++
+/// double total = vx::blas::sum<double, vx::summation::neumaier>(amounts);
+/// ```
+template <typename T, summation S = summation::plain>
+T sum(std::span<const T> x)
+{
+    return accumulate<T, S>(x, [](auto v) {return v;});
+}
+
+/// Sum of absolute values `∑ |x[i]|`.
+template <typename T, summation S = summation::plain>
+T asum(std::span<const T> x)
+{
+    return accumulate<T, S>(x, [](auto v) {return abs(v);});
+}
+
+/// Maximum of absolute values, 0 for empty span.
+template <typename T>
+T amax(std::span<const T> x)
+{
+    using V = native<T>;
+    using M = typename get_mask<V>::type;
+    constexpr std::size_t N = nrelem<V>();
+    const T* px = x.data();
+    const std::size_t n = x.size();
+
+    V acc0{}, acc1{};
+    V v, v1;
+    std::size_t i = 0;
+    for (; i + 2*N <= n; i += 2*N) {
+        loadu(v, px + i); loadu(v1, px + i + N);
+        acc0 = max(acc0, abs(v)); acc1 = max(acc1, abs(v1));
+    }
+    if (i + N <= n) {
+        loadu(v, px + i);
+        acc0 = max(acc0, abs(v));
+        i += N;
+    }
+    if (i < n) {
+        maskload(v, px + i, mask_first_n<M>(n - i));
+        acc1 = max(acc1, abs(v));
+    }
+    return reduce_max(max(acc0, acc1));
+}
+
+/// Euclidean norm `sqrt(∑ x[i]²)` without overflow or underflow.
+///
+/// Fast path squares elements directly; when the sum of squares
+/// overflows or is so small that underflowed squares may matter,
+/// elements are rescaled by the largest magnitude and summed again.
+///
+/// Example:
+/// ```c++
+/// std::vector<double> x = {3e300, 4e300};
+/// assert(vx::blas::nrm2<double>(x) == 5e300);
+/// ```
+template <typename T>
+T nrm2(std::span<const T> x)
+{
+    const std::size_t n = x.size();
+    const T ssq = dot<T>(x, x);
+    constexpr T tiny = std::numeric_limits<T>::min() / std::numeric_limits<T>::epsilon();
+    if (std::isfinite(ssq) && ssq > tiny * (T)n) {
+        return std::sqrt(ssq);
+    }
+
+    const T scale = amax<T>(x);
+    if (scale == T{} || !std::isfinite(scale)) {
+        return scale;
+    }
+
+    using V = native<T>;
+    using M = typename get_mask<V>::type;
+    constexpr std::size_t N = nrelem<V>();
+    const T* px = x.data();
+    V vscale; fill(vscale, scale);
+    V acc0{}, acc1{};
+    V v;
+    std::size_t i = 0;
+    for (; i + N <= n; i += N) {
+        loadu(v, px + i);
+        v = v / vscale; // not multiply by 1/scale, it overflows for subnormal scale
+        acc0 = madd(v, v, acc0);
+    }
+    if (i < n) {
+        maskload(v, px + i, mask_first_n<M>(n - i));
+        v = v / vscale;
+        acc1 = madd(v, v, acc1);
+    }
+    return scale * std::sqrt(vx::sum<T>(acc0 + acc1));
+}
+
+/// Index of the first element with maximum absolute value,
+/// `x.size()` for empty span (like `std::max_element` returns end).
+template <typename T>
+std::size_t iamax(std::span<const T> x)
+{
+    using V = native<T>;
+    using M = typename get_mask<V>::type;
+    using I = typename get_base<M>::type;
+    constexpr std::size_t N = nrelem<V>();
+    const T* px = x.data();
+    const std::size_t n = x.size();
+
+    if (n == 0) return n;
+    if (n > (std::size_t)std::numeric_limits<I>::max() - N) {
+        // lane index does not fit, do it by scalar loop
+        std::size_t best = 0;
+        for (std::size_t i = 1; i < n; ++i) {
+            if (std::abs(px[i]) > std::abs(px[best])) best = i;
+        }
+        return best;
+    }
+
+    V best; fill(best, (T)-1); // any |x| wins over -1
+    M best_idx{};
+    M idx;
+    for (unsigned j = 0; j < N; ++j) { idx[j] = (I)j; }
+    M step; fill(step, (I)N);
+
+    V v;
+    std::size_t i = 0;
+    for (; i + N <= n; i += N, idx += step) {
+        loadu(v, px + i);
+        v = abs(v);
+        const M gt = v > best; // strict, keeps first index in lane
+        best = gt ? v : best;
+        best_idx = gt ? idx : best_idx;
+    }
+    if (i < n) {
+        const M m = mask_first_n<M>(n - i);
+        maskload(v, px + i, m);
+        V neg1; fill(neg1, (T)-1);
+        v = m ? abs(v) : neg1;
+        const M gt = v > best;
+        best = gt ? v : best;
+        best_idx = gt ? idx : best_idx;
+    }
+
+    const T top = reduce_max(best);
+    M no_idx; fill(no_idx, std::numeric_limits<I>::max());
+    V vtop; fill(vtop, top);
+    return (std::size_t)reduce_min(best == vtop ? best_idx : no_idx);
+}
+
+/// Strided copy `y[i*incy] = x[i*incx]` for `i` in `[0, n)`.
+///
+/// Negative increments walk memory backwards from `x` and `y`.
+/// Non-unit strides are gathered/scattered a vector at a time.
+///
+/// Example:
+/// ```c++
+/// double m[4][4];
+/// double col[4];
+/// vx::blas::copy(4, &m[0][1], 4, col, 1); // copy column 1
+/// ```
+template <typename T>
+void copy(std::size_t n, const T* x, std::ptrdiff_t incx, T* y, std::ptrdiff_t incy)
+{
+    if (incx == 1 && incy == 1) {
+        if (n) std::memcpy(y, x, n * sizeof(T));
+        return;
+    }
+
+    using V = native<T>;
+    constexpr std::size_t N = nrelem<V>();
+    using I = typename make<int32_t, N>::type;
+    constexpr std::ptrdiff_t max_inc = std::numeric_limits<int32_t>::max() / (std::ptrdiff_t)N;
+
+    std::size_t i = 0;
+    if (std::abs(incx) < max_inc && std::abs(incy) < max_inc) {
+        I iota;
+        for (unsigned j = 0; j < N; ++j) { iota[j] = (int32_t)j; }
+        const I xindex = iota * (int32_t)incx;
+        const I yindex = iota * (int32_t)incy;
+        V v;
+        for (; i + N <= n; i += N) {
+            const T* px = x + (std::ptrdiff_t)i * incx;
+            T* py = y + (std::ptrdiff_t)i * incy;
+            if (incx == 1) loadu(v, px);
+            else gather(v, px, xindex);
+            if (incy == 1) storeu(py, v);
+            else scatter(py, yindex, v);
+        }
+    }
+    for (; i < n; ++i) {
+        y[(std::ptrdiff_t)i * incy] = x[(std::ptrdiff_t)i * incx];
+    }
+}
+
+// vx::array forms
+
+template <typename T, summation S = summation::plain, std::size_t Sz>
+T dot(const array<T,Sz>& x, const array<T,Sz>& y) {return dot<T, S>(x.elements(), y.elements());}
+
+template <typename T, std::size_t Sz>
+void axpy(const T a, const array<T,Sz>& x, array<T,Sz>& y) {axpy<T>(a, x.elements(), y.elements());}
+
+template <typename T, std::size_t Sz>
+void scal(const T a, array<T,Sz>& x) {scal<T>(a, x.elements());}
+
+template <typename T, summation S = summation::plain, std::size_t Sz>
+T sum(const array<T,Sz>& x) {return sum<T, S>(x.elements());}
+
+template <typename T, summation S = summation::plain, std::size_t Sz>
+T asum(const array<T,Sz>& x) {return asum<T, S>(x.elements());}
+
+template <typename T, std::size_t Sz>
+T nrm2(const array<T,Sz>& x) {return nrm2<T>(x.elements());}
+
+template <typename T, std::size_t Sz>
+std::size_t iamax(const array<T,Sz>& x) {return iamax<T>(x.elements());}
+
+} // namespace vx::blas
@@ -0,0 +1,178 @@
+/**@file
+ * @brief     Compositing of premultiplied RGBA8 pixels.
+ * @author    Igor Lesik 2021
+ * @copyright Igor Lesik 2021
+ *
+ * Pixels are `uint32_t` with channel bytes in memory order, alpha is the
+ * last byte (RGBA or BGRA), colors are premultiplied by alpha (`c <= a`).
+ * Every mode is the same formula on all four bytes, for alpha too:
+ * ```
+ * src_over  s + d*(255 - sa)/255
+ * multiply  (s*d + s*(255 - da) + d*(255 - sa))/255
+ * screen    s + d - s*d/255
+ * add       min(s + d, 255)
+ * ```
+ * Division by 255 rounds to nearest and is exact: 16-bit products are
+ * divided with `(x + 128) * 257 >> 16` (`pmulhuw`). Bytes are widened to
+ * 16 bits as even and odd bytes of 16-bit lanes, so no lane crossing
+ * unpacks are needed. Row tails use masked load/store of pixels.
+ */
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#include "vx/vxtypes.hpp"
+#include "vx/vxops.hpp"
+#include "vx/vxfun.hpp"
+
+namespace vx::image {
+
+/// Blend mode of `blend`, source is composited onto destination.
+enum class blend_mode {src_over, multiply, screen, add};
+
+namespace detail::blend {
+
+using P = native<uint32_t>;
+using M = typename get_mask<P>::type;
+constexpr std::size_t N = nrelem<P>();
+using B = typename make<uint8_t, 4*N>::type;
+using W = typename make<uint16_t, 2*N>::type;
+
+/// Even and odd bytes in 16-bit lanes, and back.
+inline W lo(const B v) {return (W)v & 0xFF;}
+inline W hi(const B v) {return (W)v >> 8;}
+inline B join(const W l, const W h) {return (B)(l | h << 8);}
+
+/// Rounded `x/255` of `x <= 255*255`.
+inline W div255(const W x)
+{
+    return mulhi(x + 128, broadcast<W>(257));
+}
+
+/// Rounded `a*b/255` of all bytes, `b` is the same in both bytes of a 16-bit lane.
+inline B mul255(const B a, const W b)
+{
+    return join(div255(lo(a) * b), div255(hi(a) * b));
+}
+
+/// Alpha byte of every pixel in all its bytes.
+inline B alpha(const B v)
+{
+    constexpr auto idx = lane_mask<B>([](std::size_t k) {return k | 3;});
+    return __builtin_shuffle(v, idx);
+}
+
+/// `dst[i] = f(src[i], dst[i])`, or `f(src[i])`, on vectors of pixels as bytes.
+template <typename Fn>
+void transform(const uint32_t* src, uint32_t* dst, std::size_t n, Fn f)
+{
+    constexpr bool unary = std::is_invocable_v<Fn, B>;
+    const auto g = [&](P s, P d) -> P {
+        if constexpr (unary) return (P)f((B)s);
+        else return (P)f((B)s, (B)d);
+    };
+    std::size_t i = 0;
+    for (; i + N <= n; i += N) {
+        P s, d{};
+        loadu(s, src + i);
+        if constexpr (!unary) loadu(d, dst + i);
+        storeu(dst + i, g(s, d));
+    }
+    if (i < n) {
+        const M m = mask_first_n<M>(n - i);
+        P s{}, d{};
+        maskload(s, src + i, m);
+        if constexpr (!unary) maskload(d, dst + i, m);
+        maskstore(dst + i, g(s, d), m);
+    }
+}
+
+/// `s OP d` of premultiplied pixels.
+template <blend_mode Mode>
+inline B apply(const B s, const B d)
+{
+    if constexpr (Mode == blend_mode::src_over) {
+        return add_saturated(s, mul255(d, lo(~alpha(s))));
+    }
+    else if constexpr (Mode == blend_mode::multiply) {
+        // s*(d + 255 - da) + d*(255 - sa) <= 255*255 for premultiplied pixels
+        const W isa = lo(~alpha(s)), ida = lo(~alpha(d));
+        const W l = lo(s) * (lo(d) + ida) + lo(d) * isa;
+        const W h = hi(s) * (hi(d) + ida) + hi(d) * isa;
+        return join(div255(l), div255(h));
+    }
+    else if constexpr (Mode == blend_mode::screen) {
+        // result fits a byte, wrapping byte arithmetic is exact
+        const B sd = join(div255(lo(s) * lo(d)), div255(hi(s) * hi(d)));
+        return s + d - sd;
+    }
+    else {
+        static_assert(Mode == blend_mode::add);
+        return add_saturated(s, d);
+    }
+}
+
+} // namespace detail::blend
+
+/// Composites premultiplied `src` pixels onto `dst`, `dst[i] = src[i]*opacity/255 OP dst[i]`.
+///
+/// Example:
+/// ```c++
+/// vx::image::blend<vx::image::blend_mode::src_over>(layer_row, frame_row);
+/// vx::image::blend<vx::image::blend_mode::screen>(glow_row, frame_row, 128); // half opacity
+/// ```
+template <blend_mode Mode>
+void blend(std::span<const uint32_t> src, std::span<uint32_t> dst, uint8_t opacity = 255)
+{
+    using namespace detail::blend;
+    assert(src.size() == dst.size());
+    if (opacity == 255) {
+        transform(src.data(), dst.data(), src.size(), [](B s, B d) {return apply<Mode>(s, d);});
+    }
+    else {
+        const W o = broadcast<W>(opacity);
+        transform(src.data(), dst.data(), src.size(), [o](B s, B d) {return apply<Mode>(mul255(s, o), d);});
+    }
+}
+
+/// Multiplies color channels by alpha, `out = c*a/255` rounded, alpha is kept.
+/// `in` and `out` may be the same array.
+inline void premultiply(std::span<const uint32_t> in, std::span<uint32_t> out)
+{
+    using namespace detail::blend;
+    assert(in.size() == out.size());
+    const B keep = (B)broadcast<P>(0xFF000000);
+    transform(in.data(), out.data(), in.size(), [&](B p) {
+        const B a = alpha(p);
+        return (mul255(p, lo(a)) & ~keep) | (p & keep);
+    });
+}
+
+/// Divides color channels by alpha, `out = min(255, round(c*255/a))`, 0 where `a == 0`.
+/// `in` and `out` may be the same array.
+inline void unpremultiply(std::span<const uint32_t> in, std::span<uint32_t> out)
+{
+    using namespace detail::blend;
+    using F = typename make<float, N>::type;
+    using I = typename get_mask<F>::type;
+    assert(in.size() == out.size());
+    transform(in.data(), out.data(), in.size(), [](B b) {
+        const P p = (P)b, a = p >> 24;
+        // c*255 and a are exact in float and quotients are at least 1/2a away from
+        // a half unless exactly on it, so +0.5 and truncation round half up
+        const F fa = max(__builtin_convertvector((I)a, F), broadcast<F>(1.0f));
+        P r = p & 0xFF000000;
+        for (unsigned k = 0; k < 3; ++k) {
+            const F c = __builtin_convertvector((I)(p >> 8*k & 0xFF), F);
+            const P q = (P)__builtin_convertvector(c * 255.0f / fa + 0.5f, I);
+            r |= min(q, broadcast<P>(255)) << 8*k;
+        }
+        return (B)(a == 0 ? P{} : r);
+    });
+}
+
+} // namespace vx::image
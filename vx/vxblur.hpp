@@ -0,0 +1,343 @@
+/**@file
+ * @brief     Separable filters, Gaussian and box blur of planar U8, U16 and F32 images.
+ * @author    Igor Lesik 2021
+ * @copyright Igor Lesik 2021
+ *
+ * Images are one plane of `width×height` elements, `stride` elements apart
+ * row to row. Pixels outside the image are given by a `border` mode.
+ *
+ * Filters run on strips of `strip_width` columns so that the rows of a
+ * strip that the vertical pass reads stay in cache while the strip is
+ * walked down. Vertical pass is vectorized across columns: it weights whole
+ * row segments into a float row with horizontal halo, then horizontal pass
+ * weights unaligned loads of that row. Halo columns outside the image are
+ * mapped by the border mode and computed one by one.
+ *
+ * Box blur keeps running column sums, one row added and one removed per
+ * output row, and turns them into window sums with a vector prefix sum.
+ * Integer images sum exactly in 32 bits and round `(sum + area/2) / area`
+ * with `vx::divider`.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "vx/vxtypes.hpp"
+#include "vx/vxops.hpp"
+#include "vx/vxfun.hpp"
+#include "vx/vxdivider.hpp"
+
+namespace vx::image {
+
+/// Pixels outside the image, for row `abcd`.
+enum class border
+{
+    replicate,  ///< `aaa|abcd|ddd`
+    reflect,    ///< `cba|abcd|dcb`
+    reflect101, ///< `dcb|abcd|cba`
+    wrap,       ///< `bcd|abcd|abc`
+    zero        ///< `000|abcd|000`
+};
+
+/// Columns per strip of the vertical pass.
+constexpr std::size_t strip_width = 1024;
+
+namespace detail::blur {
+
+using F = native<float>;
+constexpr std::size_t N = nrelem<F>();
+using I = typename get_mask<F>::type;
+
+/// Index of `i` in `[0, n)` by border mode, -1 for zero.
+inline std::ptrdiff_t map(std::ptrdiff_t i, std::ptrdiff_t n, border b)
+{
+    if (i >= 0 and i < n) return i;
+    switch (b) {
+    case border::replicate:
+        return i < 0 ? 0 : n - 1;
+    case border::wrap:
+        return (i % n + n) % n;
+    case border::zero:
+        return -1;
+    default: {
+        // mirrored with period 2n, or 2n-2 without repeating the edge
+        const bool edge = b == border::reflect;
+        if (!edge and n == 1) return 0;
+        const std::ptrdiff_t p = edge ? 2*n : 2*n - 2;
+        i = (i % p + p) % p;
+        return i < n ? i : edge ? p - 1 - i : p - i;
+    }
+    }
+}
+
+/// Source rows of image rows `y0..y0+k-1`, zero border rows point to `zero`.
+template <typename T>
+void map_rows(const T* src, std::size_t stride, std::size_t height, border b,
+    std::ptrdiff_t y0, const T* zero, std::span<const T*> rows)
+{
+    for (std::size_t k = 0; k < rows.size(); ++k) {
+        const std::ptrdiff_t r = map(y0 + (std::ptrdiff_t)k, height, b);
+        rows[k] = r < 0 ? zero : src + r*stride;
+    }
+}
+
+/// `N` elements of `p` as float.
+template <typename T>
+inline F load(const T* p)
+{
+    if constexpr (std::is_same_v<T, float>) {
+        F v;
+        loadu(v, p);
+        return v;
+    }
+    else {
+        I v;
+        loadu_widen(v, p);
+        return __builtin_convertvector(v, F);
+    }
+}
+
+/// Rounds to nearest even and saturates to `T`.
+template <typename T>
+inline T narrow(float v)
+{
+    if constexpr (std::is_same_v<T, float>) return v;
+    else return (T)std::clamp(std::nearbyint(v), 0.0f, (float)std::numeric_limits<T>::max());
+}
+
+/// Stores `N` integers that fit `T` to `p`.
+template <typename T, typename V>
+inline void store_narrow(T* p, const V v)
+{
+    const auto n = __builtin_convertvector(v, typename make<T, N>::type);
+    std::memcpy(p, &n, sizeof(n));
+}
+
+/// Stores `N` floats to `p` rounded and saturated like `narrow`.
+template <typename T>
+inline void store(T* p, const F v)
+{
+    if constexpr (std::is_same_v<T, float>) {
+        storeu(p, v);
+    }
+    else {
+        store_narrow(p, min(max(round_to_int(v), I{}), broadcast<I>(std::numeric_limits<T>::max())));
+    }
+}
+
+/// Inclusive prefix sum of lanes, `log2(n)` shifted adds.
+template <std::size_t S = 1, typename V>
+inline V prefix_sum(V v)
+{
+    constexpr std::size_t n = nrelem<V>();
+    if constexpr (S >= n) {
+        return v;
+    }
+    else {
+        // lane i gets lane i-S, first S lanes get zero from the second operand
+        constexpr auto up = lane_mask<V>([](std::size_t i) {return i >= S ? i - S : n + i;});
+        return prefix_sum<2*S>(v + __builtin_shuffle(v, V{}, up));
+    }
+}
+
+/// Columns `[lo, hi)` of a strip with halo: `[a, b)` inside the image, others mapped by border mode.
+struct strip
+{
+    std::ptrdiff_t lo, hi, a, b;
+
+    strip(std::ptrdiff_t x0, std::ptrdiff_t x1, std::ptrdiff_t left, std::ptrdiff_t right, std::ptrdiff_t width) :
+        lo(x0 - left), hi(x1 + right), a(std::max(lo, (std::ptrdiff_t)0)), b(std::min(hi, width)) {}
+
+    /// Calls `f(x)` for halo columns outside the image.
+    template <typename Fn>
+    void outside(Fn f) const
+    {
+        for (std::ptrdiff_t x = lo; x < a; ++x) f(x);
+        for (std::ptrdiff_t x = std::max(b, a); x < hi; ++x) f(x);
+    }
+};
+
+} // namespace detail::blur
+
+/// Filters with separable kernel, `dst = kx ⊗ (ky ⊗ src)`, `kx` and `ky` have odd
+/// sizes and are centered. Integer results are rounded and saturated.
+///
+/// Example:
+/// ```c++
+/// const float k[] = {1/4.f, 2/4.f, 1/4.f};
+/// vx::image::separable_filter<uint8_t>(src, w, dst, w, w, h, k, k);
+/// ```
+template <typename T>
+void separable_filter(const T* src, std::size_t src_stride, T* dst, std::size_t dst_stride,
+    std::size_t width, std::size_t height, std::span<const float> kx, std::span<const float> ky,
+    border bm = border::reflect101)
+{
+    using namespace detail::blur;
+    assert(kx.size() % 2 == 1 and ky.size() % 2 == 1);
+    const std::ptrdiff_t w = width, rx = kx.size() / 2, ry = ky.size() / 2;
+
+    std::vector<F> vkx(kx.size()), vky(ky.size());
+    for (std::size_t j = 0; j < kx.size(); ++j) vkx[j] = broadcast<F>(kx[j]);
+    for (std::size_t k = 0; k < ky.size(); ++k) vky[k] = broadcast<F>(ky[k]);
+    const std::vector<T> zero(width);
+    std::vector<const T*> rows(ky.size());
+    std::vector<float> tmp(strip_width + 2*rx);
+
+    for (std::ptrdiff_t x0 = 0; x0 < w; x0 += strip_width) {
+        const std::ptrdiff_t x1 = std::min(x0 + (std::ptrdiff_t)strip_width, w);
+        const strip s(x0, x1, rx, rx, w);
+        float* t = tmp.data();
+        for (std::size_t y = 0; y < height; ++y) {
+            map_rows<T>(src, src_stride, height, bm, y - ry, zero.data(), rows);
+            // vertical pass, t[x - lo] for columns of the strip with halo
+            std::ptrdiff_t x = s.a;
+            for (; x + (std::ptrdiff_t)N <= s.b; x += N) {
+                F acc{};
+                for (std::size_t k = 0; k < rows.size(); ++k) acc = madd(vky[k], load(rows[k] + x), acc);
+                storeu(t + (x - s.lo), acc);
+            }
+            const auto column = [&](std::ptrdiff_t x, std::ptrdiff_t c) {
+                float acc = 0;
+                if (c >= 0) for (std::size_t k = 0; k < rows.size(); ++k) acc += ky[k] * rows[k][c];
+                t[x - s.lo] = acc;
+            };
+            for (; x < s.b; ++x) column(x, x);
+            s.outside([&](std::ptrdiff_t x) {column(x, map(x, w, bm));});
+
+            // horizontal pass
+            T* out = dst + y*dst_stride;
+            x = x0;
+            for (; x + (std::ptrdiff_t)N <= x1; x += N) {
+                const float* p = t + (x - x0);
+                F acc{};
+                for (std::size_t j = 0; j < kx.size(); ++j) {
+                    F v;
+                    loadu(v, p + j);
+                    acc = madd(vkx[j], v, acc);
+                }
+                store(out + x, acc);
+            }
+            for (; x < x1; ++x) {
+                float acc = 0;
+                for (std::size_t j = 0; j < kx.size(); ++j) acc += kx[j] * t[x - x0 + j];
+                out[x] = narrow<T>(acc);
+            }
+        }
+    }
+}
+
+/// Gaussian blur, kernel of radius `max(1, ceil(3*sigma))` normalized to sum 1.
+///
+/// Example:
+/// ```c++
+/// vx::image::gaussian_blur<uint8_t>(src, w, dst, w, w, h, 2.0f);
+/// ```
+template <typename T>
+void gaussian_blur(const T* src, std::size_t src_stride, T* dst, std::size_t dst_stride,
+    std::size_t width, std::size_t height, float sigma, border bm = border::reflect101)
+{
+    assert(sigma > 0);
+    const std::ptrdiff_t r = std::max(1.0f, std::ceil(3*sigma));
+    std::vector<float> k(2*r + 1);
+    float sum = 0;
+    for (std::ptrdiff_t i = -r; i <= r; ++i) sum += k[i + r] = std::exp(-(float)(i*i) / (2*sigma*sigma));
+    for (auto& v : k) v /= sum;
+    separable_filter<T>(src, src_stride, dst, dst_stride, width, height, k, k, bm);
+}
+
+/// Box blur, mean of `(2*radius + 1)²` pixels. Integer means are rounded half up
+/// and exact; `uint8_t` radius is below 2048 and `uint16_t` radius below 128.
+/// Float sums are running sums and carry rounding errors of the row and column updates.
+///
+/// Example:
+/// ```c++
+/// vx::image::box_blur<uint8_t>(src, w, dst, w, w, h, 3); // 7×7 mean
+/// ```
+template <typename T>
+void box_blur(const T* src, std::size_t src_stride, T* dst, std::size_t dst_stride,
+    std::size_t width, std::size_t height, std::size_t radius, border bm = border::reflect101)
+{
+    using namespace detail::blur;
+    using A = std::conditional_t<std::is_same_v<T, float>, float, uint32_t>;
+    using VA = typename make<A, N>::type;
+    const std::ptrdiff_t w = width, h = height, r = radius;
+    const uint64_t area = (2*radius + 1) * (2*radius + 1);
+    assert((std::is_same_v<T, float> or area * (std::numeric_limits<T>::max() + 1ull) <= 1ull << 32));
+
+    const std::vector<T> zero(width);
+    const auto row = [&](std::ptrdiff_t y) {
+        const std::ptrdiff_t m = map(y, h, bm);
+        return m < 0 ? zero.data() : src + m*src_stride;
+    };
+    const auto load_sum = [](const T* p) {
+        if constexpr (std::is_same_v<T, float>) return load(p);
+        else {VA v; loadu_widen(v, p); return v;}
+    };
+    const divider<uint32_t> div(area);
+    const auto mean = [&](VA s) {
+        if constexpr (std::is_same_v<T, float>) return s * (1.0f / area);
+        else return (s + (uint32_t)(area / 2)) / div;
+    };
+    const auto mean1 = [&](A s) -> T {
+        if constexpr (std::is_same_v<T, float>) return s * (1.0f / area);
+        else return (s + area / 2) / area;
+    };
+    std::vector<A> sums(strip_width + 2*r);
+
+    for (std::ptrdiff_t x0 = 0; x0 < w; x0 += strip_width) {
+        const std::ptrdiff_t x1 = std::min(x0 + (std::ptrdiff_t)strip_width, w);
+        const strip s(x0, x1, r, r, w);
+        A* c = sums.data();
+
+        // column sums c[x - lo] += row p - row q, halo columns by border mode
+        const auto update = [&](const T* p, const T* q) {
+            std::ptrdiff_t x = s.a;
+            for (; x + (std::ptrdiff_t)N <= s.b; x += N) {
+                VA v;
+                loadu(v, c + (x - s.lo));
+                storeu(c + (x - s.lo), v + load_sum(p + x) - load_sum(q + x));
+            }
+            for (; x < s.b; ++x) c[x - s.lo] += (A)p[x] - (A)q[x];
+            s.outside([&](std::ptrdiff_t x) {
+                const std::ptrdiff_t m = map(x, w, bm);
+                if (m >= 0) c[x - s.lo] += (A)p[m] - (A)q[m];
+            });
+        };
+        std::fill(c, c + (s.hi - s.lo), A{});
+        for (std::ptrdiff_t k = -r; k <= r; ++k) update(row(k), zero.data());
+
+        for (std::ptrdiff_t y = 0; y < h; ++y) {
+            T* out = dst + y*dst_stride;
+            // window sums of 2r+1 columns, each from the previous one
+            A acc = 0;
+            for (std::ptrdiff_t j = 0; j <= 2*r; ++j) acc += c[j];
+            out[x0] = mean1(acc);
+            std::ptrdiff_t x = x0 + 1;
+            for (; x + (std::ptrdiff_t)N <= x1; x += N) {
+                VA in, off;
+                loadu(in, c + (x - x0) + 2*r);
+                loadu(off, c + (x - x0) - 1);
+                const VA v = prefix_sum(in - off) + acc;
+                if constexpr (std::is_same_v<T, float>) storeu(out + x, mean(v));
+                else store_narrow(out + x, mean(v)); // from unsigned, GCC 12 scalarizes signed
+                acc = v[N - 1];
+            }
+            for (; x < x1; ++x) {
+                acc += c[x - x0 + 2*r] - c[x - x0 - 1];
+                out[x] = mean1(acc);
+            }
+            if (y + 1 < h) update(row(y + r + 1), row(y - r));
+        }
+    }
+}
+
+} // namespace vx::image
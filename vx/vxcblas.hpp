@@ -0,0 +1,380 @@
+/**@file
+ * @brief     Complex BLAS kernels: dot, dotc, axpy and GEMM.
+ * @author    Igor Lesik 2021
+ * @copyright Igor Lesik 2021
+ *
+ * Level-1 kernels come in two layouts:
+ * split `vx::cx::Complex<V>` vectors, where a complex multiply-accumulate
+ * is four FMA without shuffles, and interleaved `std::complex<T>` arrays,
+ * where it is one swap shuffle and `fmaddsub`.
+ *
+ * `gemm` works on split real/imaginary planes: B is packed into panels
+ * of `2*nrelem<V>()` columns, the microkernel keeps a block of C
+ * in registers and updates it with four FMA per complex product.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <complex>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "vx/vxtypes.hpp"
+#include "vx/vxops.hpp"
+#include "vx/vxfun.hpp"
+#include "vx/vxcomplex.hpp"
+
+namespace vx::cx::blas {
+
+namespace detail {
+
+/// Element type of vector `V`, unlike `get_base` substitution failure is not an error,
+/// so split and interleaved overloads can share names.
+template <typename V>
+using elem_t = std::remove_cvref_t<decltype(std::declval<V>()[0])>;
+
+} // namespace detail
+
+/// Unconjugated dot product `∑ x[i]*y[i]` of split complex vectors.
+///
+/// Example:
+/// ```c++
+/// std::vector<vx::cx::Complex<F32x8>> x(n), y(n);
+/// std::complex<float> d = vx::cx::blas::dot<F32x8>(x, y);
+/// ```
+template <typename V>
+std::complex<detail::elem_t<V>> dot(std::span<const Complex<V>> x, std::span<const Complex<V>> y)
+{
+    assert(x.size() == y.size());
+    using T = typename get_base<V>::type;
+    const std::size_t n = x.size();
+
+    // two accumulator sets to hide FMA latency
+    V re0{}, im0{}, re1{}, im1{};
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        re0 = vx::madd(x[i].real, y[i].real, re0);         im0 = vx::madd(x[i].real, y[i].img, im0);
+        re0 = vx::nmadd(x[i].img, y[i].img, re0);          im0 = vx::madd(x[i].img, y[i].real, im0);
+        re1 = vx::madd(x[i+1].real, y[i+1].real, re1);     im1 = vx::madd(x[i+1].real, y[i+1].img, im1);
+        re1 = vx::nmadd(x[i+1].img, y[i+1].img, re1);      im1 = vx::madd(x[i+1].img, y[i+1].real, im1);
+    }
+    if (i < n) {
+        re0 = vx::madd(x[i].real, y[i].real, re0);         im0 = vx::madd(x[i].real, y[i].img, im0);
+        re0 = vx::nmadd(x[i].img, y[i].img, re0);          im0 = vx::madd(x[i].img, y[i].real, im0);
+    }
+    return {vx::sum<T>(re0 + re1), vx::sum<T>(im0 + im1)};
+}
+
+/// Conjugated dot product `∑ conj(x[i])*y[i]` of split complex vectors.
+template <typename V>
+std::complex<detail::elem_t<V>> dotc(std::span<const Complex<V>> x, std::span<const Complex<V>> y)
+{
+    assert(x.size() == y.size());
+    using T = typename get_base<V>::type;
+    const std::size_t n = x.size();
+
+    V re0{}, im0{}, re1{}, im1{};
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        re0 = vx::madd(x[i].real, y[i].real, re0);         im0 = vx::madd(x[i].real, y[i].img, im0);
+        re0 = vx::madd(x[i].img, y[i].img, re0);           im0 = vx::nmadd(x[i].img, y[i].real, im0);
+        re1 = vx::madd(x[i+1].real, y[i+1].real, re1);     im1 = vx::madd(x[i+1].real, y[i+1].img, im1);
+        re1 = vx::madd(x[i+1].img, y[i+1].img, re1);       im1 = vx::nmadd(x[i+1].img, y[i+1].real, im1);
+    }
+    if (i < n) {
+        re0 = vx::madd(x[i].real, y[i].real, re0);         im0 = vx::madd(x[i].real, y[i].img, im0);
+        re0 = vx::madd(x[i].img, y[i].img, re0);           im0 = vx::nmadd(x[i].img, y[i].real, im0);
+    }
+    return {vx::sum<T>(re0 + re1), vx::sum<T>(im0 + im1)};
+}
+
+/// Computes `y = a*x + y` on split complex vectors.
+template <typename V>
+void axpy(const std::complex<detail::elem_t<V>> a, std::span<const Complex<V>> x, std::span<Complex<V>> y)
+{
+    assert(x.size() == y.size());
+    const Complex<V> va{real: broadcast<V>(a.real()), img: broadcast<V>(a.imag())};
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        y[i] = mul_add(va, x[i], y[i]);
+    }
+}
+
+namespace detail {
+
+template <typename V>
+constexpr auto swap_mask = lane_mask<V>([](std::size_t j) {return j ^ 1;});
+
+/// `acc_p += x*y`, `acc_q += swap(x)*y` on interleaved pairs.
+template <typename V>
+inline void dot_step(const V x, const V y, V& acc_p, V& acc_q)
+{
+    acc_p = vx::madd(x, y, acc_p);
+    acc_q = vx::madd(__builtin_shuffle(x, swap_mask<V>), y, acc_q);
+}
+
+/// Accumulates `x*y` and `swap(x)*y` over interleaved arrays of `n` complex numbers.
+///
+/// For pair `(xr, xi)`, `(yr, yi)` the `p` lanes hold `(xr yr, xi yi)` and the
+/// `q` lanes `(xi yr, xr yi)`, every product of the complex multiply.
+template <typename T>
+void dot_sums(const T* px, const T* py, std::size_t n, native<T>& p, native<T>& q)
+{
+    using V = native<T>;
+    using M = typename get_mask<V>::type;
+    constexpr std::size_t N = nrelem<V>();
+    const std::size_t len = 2 * n;
+
+    V p0{}, q0{}, p1{}, q1{};
+    V a, b;
+    std::size_t i = 0;
+    for (; i + 2*N <= len; i += 2*N) {
+        V a1, b1;
+        loadu(a,  px + i);     loadu(b,  py + i);
+        loadu(a1, px + i + N); loadu(b1, py + i + N);
+        dot_step(a, b, p0, q0);
+        dot_step(a1, b1, p1, q1);
+    }
+    for (; i + N <= len; i += N) {
+        loadu(a, px + i); loadu(b, py + i);
+        dot_step(a, b, p0, q0);
+    }
+    if (i < len) {
+        const M m = mask_first_n<M>(len - i);
+        a = V{}; b = V{};
+        maskload(a, px + i, m); maskload(b, py + i, m);
+        dot_step(a, b, p1, q1);
+    }
+    p = p0 + p1;
+    q = q0 + q1;
+}
+
+/// `y + a*x` on interleaved pairs, `ar`/`ai` are `a.real()`/`a.imag()` broadcast.
+///
+/// `fmaddsub(x, ar, fmaddsub(swap(x), ai, y))`:
+/// `(xr ar − (xi ai − yr), xi ar + (xr ai + yi))`.
+template <typename V>
+inline V axpy_step(const V ar, const V ai, const V x, const V y)
+{
+    return vx::fmaddsub(x, ar, vx::fmaddsub(__builtin_shuffle(x, swap_mask<V>), ai, y));
+}
+
+} // namespace detail
+
+/// Unconjugated dot product `∑ x[i]*y[i]` of interleaved `std::complex<T>` arrays.
+///
+/// Example:
+/// ```c++
+/// std::vector<std::complex<float>> x(n), y(n);
+/// std::complex<float> d = vx::cx::blas::dot<float>(x, y);
+/// ```
+template <typename T>
+std::complex<T> dot(std::span<const std::complex<T>> x, std::span<const std::complex<T>> y)
+{
+    assert(x.size() == y.size());
+    native<T> p, q;
+    detail::dot_sums(reinterpret_cast<const T*>(x.data()), reinterpret_cast<const T*>(y.data()), x.size(), p, q);
+    // re = ∑ xr yr − xi yi, im = ∑ xi yr + xr yi
+    return {vx::sum<T>(vx::negate_alternate<true>(p)), vx::sum<T>(q)};
+}
+
+/// Conjugated dot product `∑ conj(x[i])*y[i]` of interleaved `std::complex<T>` arrays.
+template <typename T>
+std::complex<T> dotc(std::span<const std::complex<T>> x, std::span<const std::complex<T>> y)
+{
+    assert(x.size() == y.size());
+    native<T> p, q;
+    detail::dot_sums(reinterpret_cast<const T*>(x.data()), reinterpret_cast<const T*>(y.data()), x.size(), p, q);
+    // re = ∑ xr yr + xi yi, im = ∑ xr yi − xi yr
+    return {vx::sum<T>(p), vx::sum<T>(vx::negate_alternate<false>(q))};
+}
+
+/// Computes `y = a*x + y` on interleaved `std::complex<T>` arrays.
+template <typename T>
+void axpy(const std::complex<T> a, std::span<const std::complex<T>> x, std::span<std::complex<T>> y)
+{
+    assert(x.size() == y.size());
+    using V = native<T>;
+    using M = typename get_mask<V>::type;
+    constexpr std::size_t N = nrelem<V>();
+    const T* px = reinterpret_cast<const T*>(x.data());
+    T* py = reinterpret_cast<T*>(y.data());
+    const std::size_t len = 2 * x.size();
+    const V ar = broadcast<V>(a.real()), ai = broadcast<V>(a.imag());
+
+    V vx, vy;
+    std::size_t i = 0;
+    for (; i + 2*N <= len; i += 2*N) {
+        V vx1, vy1;
+        loadu(vx,  px + i);     loadu(vy,  py + i);
+        loadu(vx1, px + i + N); loadu(vy1, py + i + N);
+        storeu(py + i,     detail::axpy_step(ar, ai, vx,  vy));
+        storeu(py + i + N, detail::axpy_step(ar, ai, vx1, vy1));
+    }
+    for (; i + N <= len; i += N) {
+        loadu(vx, px + i); loadu(vy, py + i);
+        storeu(py + i, detail::axpy_step(ar, ai, vx, vy));
+    }
+    if (i < len) {
+        const M m = mask_first_n<M>(len - i);
+        vx = V{}; vy = V{};
+        maskload(vx, px + i, m); maskload(vy, py + i, m);
+        maskstore(py + i, detail::axpy_step(ar, ai, vx, vy), m);
+    }
+}
+
+namespace detail {
+
+/// Rows of C per microkernel call, accumulators for 4 rows need 16 registers
+/// plus 6 for B and broadcast A, that fits AVX-512 but not the 16 AVX registers.
+constexpr std::size_t gemm_mr = (NATIVE_VSIZE >= 64) ? 4 : 2;
+constexpr std::size_t gemm_kc = 256;
+constexpr std::size_t gemm_mc = 128;
+
+/// Packs `kc` rows of B starting at column `j0` into panels of `NR` columns,
+/// `dst[p*NR + j]`, columns past `n` are zero.
+template <typename T>
+void gemm_pack(const T* src, std::size_t ldb, std::size_t kc, std::size_t j0, std::size_t n, std::size_t NR, T* dst)
+{
+    const std::size_t w = std::min(NR, n - j0);
+    for (std::size_t p = 0; p < kc; ++p) {
+        std::copy_n(src + p * ldb + j0, w, dst + p * NR);
+        std::fill_n(dst + p * NR + w, NR - w, T{});
+    }
+}
+
+/// `C[R × cols] += alpha * A[R × kc] * B[kc × NR]`, `B` is a packed panel.
+///
+/// Accumulators for the `R × 2` block of vectors stay in registers over `kc`,
+/// every complex product is four FMA on broadcast A elements.
+template <std::size_t R, typename V>
+__attribute__((always_inline))
+inline void gemm_kernel(std::size_t kc, std::complex<typename get_base<V>::type> alpha,
+    const typename get_base<V>::type* ar, const typename get_base<V>::type* ai, std::size_t lda,
+    const typename get_base<V>::type* br, const typename get_base<V>::type* bi,
+    typename get_base<V>::type* cr, typename get_base<V>::type* ci, std::size_t ldc, std::size_t cols)
+{
+    using T = typename get_base<V>::type;
+    using M = typename get_mask<V>::type;
+    constexpr std::size_t N = nrelem<V>();
+    constexpr std::size_t NR = 2 * N;
+
+    V sr[R][2] = {}, si[R][2] = {};
+    for (std::size_t p = 0; p < kc; ++p) {
+        V b0r, b1r, b0i, b1i;
+        loadu(b0r, br + p * NR); loadu(b1r, br + p * NR + N);
+        loadu(b0i, bi + p * NR); loadu(b1i, bi + p * NR + N);
+        vx::unroll<R>([&](auto r) {
+            const V xr = broadcast<V>(ar[r * lda + p]), xi = broadcast<V>(ai[r * lda + p]);
+            sr[r][0] = vx::madd(xr, b0r, sr[r][0]); si[r][0] = vx::madd(xr, b0i, si[r][0]);
+            sr[r][1] = vx::madd(xr, b1r, sr[r][1]); si[r][1] = vx::madd(xr, b1i, si[r][1]);
+            sr[r][0] = vx::nmadd(xi, b0i, sr[r][0]); si[r][0] = vx::madd(xi, b0r, si[r][0]);
+            sr[r][1] = vx::nmadd(xi, b1i, sr[r][1]); si[r][1] = vx::madd(xi, b1r, si[r][1]);
+        });
+    }
+
+    const V alr = broadcast<V>(alpha.real()), ali = broadcast<V>(alpha.imag());
+    for (std::size_t r = 0; r < R; ++r) {
+        for (std::size_t v = 0; v < 2 and v * N < cols; ++v) {
+            T* pr = cr + r * ldc + v * N;
+            T* pi = ci + r * ldc + v * N;
+            V c_r, c_i;
+            if (cols >= (v + 1) * N) {
+                loadu(c_r, pr); loadu(c_i, pi);
+                storeu(pr, vx::madd(alr, sr[r][v], vx::nmadd(ali, si[r][v], c_r)));
+                storeu(pi, vx::madd(alr, si[r][v], vx::madd(ali, sr[r][v], c_i)));
+            }
+            else {
+                const M m = mask_first_n<M>(cols - v * N);
+                c_r = V{}; c_i = V{};
+                maskload(c_r, pr, m); maskload(c_i, pi, m);
+                maskstore(pr, vx::madd(alr, sr[r][v], vx::nmadd(ali, si[r][v], c_r)), m);
+                maskstore(pi, vx::madd(alr, si[r][v], vx::madd(ali, sr[r][v], c_i)), m);
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+/// `C = alpha*A*B + beta*C` for row-major complex matrices in split layout,
+/// complex GEMM (CGEMM/ZGEMM) without transposes.
+///
+/// A is `m × k`, B is `k × n`, C is `m × n`; `real` and `img` point to
+/// separate planes sharing the leading dimension (row stride) `lda`, `ldb`, `ldc`.
+///
+/// Example:
+/// ```c++
+/// std::vector<float> ar(m*k), ai(m*k), br(k*n), bi(k*n), cr(m*n), ci(m*n);
+/// vx::cx::blas::gemm<float>(m, n, k, {1, 0},
+///     {real: ar.data(), img: ai.data()}, k, {real: br.data(), img: bi.data()}, n,
+///     {0, 0}, {real: cr.data(), img: ci.data()}, n);
+/// ```
+template <typename T>
+void gemm(std::size_t m, std::size_t n, std::size_t k, const std::complex<T> alpha,
+          Complex<const T*> a, std::size_t lda, Complex<const T*> b, std::size_t ldb,
+          const std::complex<T> beta, Complex<T*> c, std::size_t ldc)
+{
+    using V = native<T>;
+    constexpr std::size_t N = nrelem<V>();
+    constexpr std::size_t NR = 2 * N;
+    constexpr std::size_t MR = detail::gemm_mr;
+
+    for (std::size_t i = 0; i < m; ++i) {
+        T* pr = c.real + i * ldc;
+        T* pi = c.img + i * ldc;
+        if (beta == std::complex<T>{}) {
+            std::fill_n(pr, n, T{});
+            std::fill_n(pi, n, T{});
+        }
+        else if (beta != std::complex<T>{1}) {
+            for (std::size_t j = 0; j < n; ++j) {
+                const std::complex<T> z = beta * std::complex<T>{pr[j], pi[j]};
+                pr[j] = z.real();
+                pi[j] = z.imag();
+            }
+        }
+    }
+    if (alpha == std::complex<T>{} or k == 0) return;
+
+    const std::size_t panels = (n + NR - 1) / NR;
+    std::vector<T> packed(2 * panels * std::min(k, detail::gemm_kc) * NR);
+
+    for (std::size_t k0 = 0; k0 < k; k0 += detail::gemm_kc) {
+        const std::size_t kc = std::min(detail::gemm_kc, k - k0);
+        const std::size_t panel = kc * NR;
+        T* bpr = packed.data();
+        T* bpi = packed.data() + panels * panel;
+        for (std::size_t jp = 0; jp < panels; ++jp) {
+            detail::gemm_pack(b.real + k0 * ldb, ldb, kc, jp * NR, n, NR, bpr + jp * panel);
+            detail::gemm_pack(b.img  + k0 * ldb, ldb, kc, jp * NR, n, NR, bpi + jp * panel);
+        }
+
+        for (std::size_t i0 = 0; i0 < m; i0 += detail::gemm_mc) {
+            const std::size_t mc = std::min(detail::gemm_mc, m - i0);
+            for (std::size_t jp = 0; jp < panels; ++jp) {
+                const std::size_t j0 = jp * NR;
+                const std::size_t cols = std::min(NR, n - j0);
+                for (std::size_t i = i0; i < i0 + mc; i += MR) {
+                    const T* ar = a.real + i * lda + k0;
+                    const T* ai = a.img + i * lda + k0;
+                    T* cr = c.real + i * ldc + j0;
+                    T* ci = c.img + i * ldc + j0;
+                    const T* br = bpr + jp * panel;
+                    const T* bi = bpi + jp * panel;
+                    switch (std::min(MR, i0 + mc - i)) {
+                    case 4:  detail::gemm_kernel<4, V>(kc, alpha, ar, ai, lda, br, bi, cr, ci, ldc, cols); break;
+                    case 3:  detail::gemm_kernel<3, V>(kc, alpha, ar, ai, lda, br, bi, cr, ci, ldc, cols); break;
+                    case 2:  detail::gemm_kernel<2, V>(kc, alpha, ar, ai, lda, br, bi, cr, ci, ldc, cols); break;
+                    default: detail::gemm_kernel<1, V>(kc, alpha, ar, ai, lda, br, bi, cr, ci, ldc, cols); break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace vx::cx::blas
@@ -0,0 +1,384 @@
+/**@file
+ * @brief     Color space conversion of 8-bit images: RGB <-> YUV 4:2:0 and grayscale.
+ * @author    Igor Lesik 2021
+ * @copyright Igor Lesik 2021
+ *
+ * Packed pixels are `rgb` (3 bytes), `rgba` or `bgra` (4 bytes), YUV is
+ * BT.601 limited range, 4:2:0 subsampled as planar I420 (Y, U, V planes) or
+ * NV12 (Y plane, interleaved UV plane). Gray is BT.601 full range luma.
+ *
+ * All conversions use the fixed-point formulas below, vector kernels and
+ * the scalar edges compute exactly the same integers:
+ * ```
+ * gray = (77R + 150G + 29B + 128) >> 8
+ * Y    = ((66R + 129G + 25B + 128) >> 8) + 16
+ * U    = ((-38ΣR - 74ΣG + 112ΣB + 512) >> 10) + 128    Σ over the 2×2 block
+ * V    = ((112ΣR - 94ΣG - 18ΣB + 512) >> 10) + 128
+ * R    = clamp((298(Y-16) + 409(V-128) + 128) >> 8)
+ * G    = clamp((298(Y-16) - 100(U-128) - 208(V-128) + 128) >> 8)
+ * B    = clamp((298(Y-16) + 516(U-128) + 128) >> 8)
+ * ```
+ * Pixels outside an odd sized image are replicated from the last column/row.
+ *
+ * Kernels hold one pixel per 32-bit lane, `pshufb` expands 3-byte pixels.
+ * Channel bytes 0,2 and 1,3 of a lane are masked to 16-bit pairs and
+ * weighted by `madd_pairs` (`pmaddwd`), so any 16-bit coefficients are exact.
+ * 2×2 chroma sums add the two rows and swapped neighbour lanes.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "vx/vxtypes.hpp"
+#include "vx/vxops.hpp"
+#include "vx/vxfun.hpp"
+
+namespace vx::image {
+
+/// Byte order of packed pixels.
+enum class pixel_format {rgb, rgba, bgra};
+
+namespace detail {
+
+using U = native<uint32_t>;
+using I = native<int32_t>;
+using H = native<int16_t>;
+constexpr std::size_t N = nrelem<U>();
+
+/// Bytes per pixel.
+template <pixel_format F>
+constexpr std::size_t bpp = F == pixel_format::rgb ? 3 : 4;
+
+/// Byte offsets of red and blue in a pixel, green is always 1.
+template <pixel_format F>
+constexpr std::size_t r_at = F == pixel_format::bgra ? 2 : 0;
+template <pixel_format F>
+constexpr std::size_t b_at = 2 - r_at<F>;
+
+constexpr uint8_t clamp8(int x) {return (uint8_t)std::clamp(x, 0, 255);}
+
+constexpr uint8_t gray(int r, int g, int b) {return (77*r + 150*g + 29*b + 128) >> 8;}
+constexpr uint8_t luma(int r, int g, int b) {return ((66*r + 129*g + 25*b + 128) >> 8) + 16;}
+/// U and V of a 2×2 block from channel sums.
+constexpr uint8_t chroma_u(int sr, int sg, int sb) {return ((-38*sr - 74*sg + 112*sb + 512) >> 10) + 128;}
+constexpr uint8_t chroma_v(int sr, int sg, int sb) {return ((112*sr - 94*sg - 18*sb + 512) >> 10) + 128;}
+
+/// Packed pixel from Y, U, V, alpha is 255.
+template <pixel_format F>
+inline void yuv_pixel(int y, int u, int v, uint8_t* p)
+{
+    const int c = 298 * (y - 16), d = u - 128, e = v - 128;
+    p[r_at<F>] = clamp8((c + 409*e + 128) >> 8);
+    p[1]       = clamp8((c - 100*d - 208*e + 128) >> 8);
+    p[b_at<F>] = clamp8((c + 516*d + 128) >> 8);
+    if constexpr (bpp<F> == 4) p[3] = 255;
+}
+
+/// Byte vector of the same size as `U`.
+using B4 = typename make<uint8_t, 4*N>::type;
+
+/// Dword shuffle of dwords 3k..3k+2 to 16-byte lane k and back.
+constexpr auto to_lanes = lane_mask<U>([](std::size_t i) {return i % 4 == 3 ? 0 : i / 4 * 3 + i % 4;});
+constexpr auto from_lanes = lane_mask<U>([](std::size_t i) {return i < 3*N/4 ? i / 3 * 4 + i % 3 : 0;});
+/// Byte shuffle of 12 bytes to 4 dwords within every 16-byte lane and back.
+constexpr auto expand = lane_mask<B4>([](std::size_t i) {
+    const std::size_t j = i % 16; return i - j + (j % 4 == 3 ? 0 : j / 4 * 3 + j % 4);});
+constexpr auto pack = lane_mask<B4>([](std::size_t i) {
+    const std::size_t j = i % 16; return i - j + (j < 12 ? j / 3 * 4 + j % 3 : 0);});
+
+/// `N` 3-byte pixels to 32-bit lanes, reads `N` bytes past the last pixel.
+inline U rgb_lanes(const uint8_t* p)
+{
+    U d;
+    std::memcpy(&d, p, sizeof(U));
+    return (U)__builtin_shuffle((B4)__builtin_shuffle(d, to_lanes), expand) & 0x00FFFFFF;
+}
+
+/// Low 3 bytes of `N` 32-bit lanes stored packed.
+inline void store_rgb(uint8_t* p, const U v)
+{
+    const U d = __builtin_shuffle((U)__builtin_shuffle((B4)v, pack), from_lanes);
+    std::memcpy(p, &d, 3*N);
+}
+
+/// `N` pixels, one per 32-bit lane in memory byte order.
+template <pixel_format F>
+inline U load_pixels(const uint8_t* p)
+{
+    if constexpr (F == pixel_format::rgb) {
+        return rgb_lanes(p);
+    }
+    else {
+        U v;
+        std::memcpy(&v, p, sizeof(U));
+        return v;
+    }
+}
+
+/// Pixels that the vector loop may load from a row of `width`, `rgb` loads read past the last pixel.
+template <pixel_format F>
+constexpr std::size_t vector_width(std::size_t width)
+{
+    const std::size_t pad = F == pixel_format::rgb ? (N + 2) / 3 : 0;
+    return width > pad ? (width - pad) / N * N : 0;
+}
+
+/// 16-bit pairs `(a, b)` in every 32-bit lane.
+inline H pair(int a, int b)
+{
+    return (H)broadcast<U>((uint32_t)(uint16_t)a | (uint32_t)(uint16_t)b << 16);
+}
+
+/// Coefficients of red, green and blue as pairs for pixel bytes (0, 2) and (1, 3).
+template <pixel_format F>
+struct weights
+{
+    H k02, k13;
+    weights(int r, int g, int b) :
+        k02(r_at<F> == 0 ? pair(r, b) : pair(b, r)), k13(pair(g, 0)) {}
+};
+
+/// Weighted sum of the channels of every lane, `lo` has bytes 0,2 and `hi` bytes 1,3 as 16-bit pairs.
+template <pixel_format F>
+inline I weigh(const I lo, const I hi, const weights<F>& w)
+{
+    return madd_pairs((H)lo, w.k02) + madd_pairs((H)hi, w.k13);
+}
+
+/// `dst[x] = (R*r + G*g + B*b + bias) >> 8` of row pixels.
+template <pixel_format F>
+void luma_row(const uint8_t* src, uint8_t* dst, std::size_t width, int r, int g, int b, int bias)
+{
+    using B = typename make<uint8_t, N>::type;
+    const weights<F> w(r, g, b);
+    const I k = broadcast<I>(bias);
+    std::size_t x = 0;
+    for (const std::size_t end = vector_width<F>(width); x < end; x += N) {
+        const U p = load_pixels<F>(src + x * bpp<F>);
+        const I s = weigh(I(p & 0x00FF00FF), I(p >> 8 & 0x00FF00FF), w);
+        const B y = __builtin_convertvector((s + k) >> 8, B);
+        std::memcpy(dst + x, &y, sizeof(B));
+    }
+    for (; x < width; ++x) {
+        const uint8_t* p = src + x * bpp<F>;
+        dst[x] = (p[r_at<F>]*r + p[1]*g + p[b_at<F>]*b + bias) >> 8;
+    }
+}
+
+/// U and V of a row pair, planar (`v != nullptr`) or interleaved into `u`.
+template <pixel_format F>
+void chroma_row(const uint8_t* top, const uint8_t* bot, uint8_t* u, uint8_t* v, std::size_t width)
+{
+    using Q = typename make<uint64_t, N/2>::type;
+    const weights<F> wu(-38, -74, 112), wv(112, -94, -18);
+    const I k = broadcast<I>(512 + (128 << 10));
+    std::size_t x = 0;
+    for (const std::size_t end = vector_width<F>(width); x < end; x += N) {
+        const U pt = load_pixels<F>(top + x * bpp<F>);
+        const U pb = load_pixels<F>(bot + x * bpp<F>);
+        // 16-bit channel sums of the two rows, then of lanes 2j and 2j+1 in lane 2j
+        I lo = I(pt & 0x00FF00FF) + I(pb & 0x00FF00FF);
+        I hi = I(pt >> 8 & 0x00FF00FF) + I(pb >> 8 & 0x00FF00FF);
+        lo += (I)((Q)lo >> 32);
+        hi += (I)((Q)hi >> 32);
+        const I cu = (weigh(lo, hi, wu) + k) >> 10;
+        const I cv = (weigh(lo, hi, wv) + k) >> 10;
+        // even lanes hold the results, 64-bit lanes truncate to them
+        if (v) {
+            const auto bu = __builtin_convertvector((Q)cu, typename make<uint8_t, N/2>::type);
+            const auto bv = __builtin_convertvector((Q)cv, typename make<uint8_t, N/2>::type);
+            std::memcpy(u + x/2, &bu, sizeof(bu));
+            std::memcpy(v + x/2, &bv, sizeof(bv));
+        }
+        else {
+            const auto uv = __builtin_convertvector((Q)(cu | cv << 8), typename make<uint16_t, N/2>::type);
+            std::memcpy(u + x, &uv, sizeof(uv));
+        }
+    }
+    for (; x < width; x += 2) {
+        const std::size_t x1 = std::min(x + 1, width - 1);
+        int s[3] = {};
+        for (const uint8_t* p : {top + x * bpp<F>, top + x1 * bpp<F>, bot + x * bpp<F>, bot + x1 * bpp<F>}) {
+            s[0] += p[r_at<F>]; s[1] += p[1]; s[2] += p[b_at<F>];
+        }
+        if (v) {
+            u[x/2] = chroma_u(s[0], s[1], s[2]);
+            v[x/2] = chroma_v(s[0], s[1], s[2]);
+        }
+        else {
+            u[x] = chroma_u(s[0], s[1], s[2]);
+            u[x + 1] = chroma_v(s[0], s[1], s[2]);
+        }
+    }
+}
+
+/// Row of packed pixels from Y and subsampled planar U, V or interleaved UV in `u` (`v == nullptr`).
+template <pixel_format F>
+void rgb_row(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, std::size_t width)
+{
+    const H kr = pair(298, 409), kg = pair(298, -100), kg2 = pair(-208, 128), kb = pair(298, 516);
+    const I lo16 = broadcast<I>(0xFFFF), zero{}, max8 = broadcast<I>(255);
+    const I round = broadcast<I>(128), one_hi = broadcast<I>(1 << 16);
+    // converts pixels x..x+N-1 with chroma of every pixel lane in `d`, `e`
+    const auto put = [&](std::size_t x, I d, I e) {
+        I c;
+        loadu_widen(c, y + x);
+        c -= 16; d -= 128; e -= 128;
+        // 16-bit pairs (c, e), (c, d), (e, 1)
+        const H ce = (H)((c & lo16) | e << 16), cd = (H)((c & lo16) | d << 16), e1 = (H)((e & lo16) | one_hi);
+        const I r = min(max((madd_pairs(ce, kr) + round) >> 8, zero), max8);
+        const I g = min(max((madd_pairs(cd, kg) + madd_pairs(e1, kg2)) >> 8, zero), max8);
+        const I b = min(max((madd_pairs(cd, kb) + round) >> 8, zero), max8);
+        const U p = U(r << 8*r_at<F> | g << 8 | b << 8*b_at<F>);
+        if constexpr (F == pixel_format::rgb) {
+            store_rgb(dst + x*3, p);
+        }
+        else {
+            const U a = p | 0xFF000000;
+            std::memcpy(dst + x*4, &a, sizeof(U));
+        }
+    };
+    // lane j to 2j and 2j+1 from the low or high half, interleaved U at 2j, V at 2j+1
+    constexpr auto dup_lo = lane_mask<I>([](std::size_t j) {return j / 2;});
+    constexpr I dup_hi = dup_lo + (int)N/2;
+    constexpr I pick_u = dup_lo * 2;
+    constexpr I pick_v = pick_u + 1;
+    std::size_t x = 0;
+    if (v) {
+        // `N` planar chroma samples cover `2N` pixels
+        for (; x + 2*N <= width; x += 2*N) {
+            I cu, cv;
+            loadu_widen(cu, u + x/2);
+            loadu_widen(cv, v + x/2);
+            put(x, __builtin_shuffle(cu, dup_lo), __builtin_shuffle(cv, dup_lo));
+            put(x + N, __builtin_shuffle(cu, dup_hi), __builtin_shuffle(cv, dup_hi));
+        }
+    }
+    else {
+        for (; x + N <= width; x += N) {
+            I uv;
+            loadu_widen(uv, u + x);
+            put(x, __builtin_shuffle(uv, pick_u), __builtin_shuffle(uv, pick_v));
+        }
+    }
+    for (; x < width; ++x) {
+        const uint8_t* c = v ? u + x/2 : u + x/2*2;
+        yuv_pixel<F>(y[x], c[0], v ? v[x/2] : c[1], dst + x * bpp<F>);
+    }
+}
+
+/// Both 4:2:0 layouts, `v == nullptr` for interleaved UV.
+template <pixel_format F>
+void to_yuv420(const uint8_t* src, std::size_t src_stride,
+    uint8_t* y, std::size_t y_stride, uint8_t* u, std::size_t u_stride, uint8_t* v, std::size_t v_stride,
+    std::size_t width, std::size_t height)
+{
+    for (std::size_t r = 0; r < height; ++r) {
+        luma_row<F>(src + r*src_stride, y + r*y_stride, width, 66, 129, 25, 128 + (16 << 8));
+    }
+    for (std::size_t r = 0; r < height; r += 2) {
+        const uint8_t* top = src + r*src_stride;
+        const uint8_t* bot = r + 1 < height ? top + src_stride : top;
+        chroma_row<F>(top, bot, u + r/2*u_stride, v ? v + r/2*v_stride : nullptr, width);
+    }
+}
+
+} // namespace detail
+
+/// Converts packed pixels to 8-bit gray (full range luma).
+///
+/// Example:
+/// ```c++
+/// vx::image::to_gray<vx::image::pixel_format::bgra>(bgra, 4*w, gray, w, w, h);
+/// ```
+template <pixel_format F>
+void to_gray(const uint8_t* src, std::size_t src_stride, uint8_t* gray, std::size_t gray_stride,
+    std::size_t width, std::size_t height)
+{
+    for (std::size_t r = 0; r < height; ++r) {
+        detail::luma_row<F>(src + r*src_stride, gray + r*gray_stride, width, 77, 150, 29, 128);
+    }
+}
+
+/// Converts 8-bit gray to packed pixels, alpha is 255.
+template <pixel_format F>
+void from_gray(const uint8_t* gray, std::size_t gray_stride, uint8_t* dst, std::size_t dst_stride,
+    std::size_t width, std::size_t height)
+{
+    using namespace detail;
+    using B = typename make<uint8_t, N>::type;
+    for (std::size_t r = 0; r < height; ++r) {
+        const uint8_t* g = gray + r*gray_stride;
+        uint8_t* d = dst + r*dst_stride;
+        std::size_t x = 0;
+        for (; x + N <= width; x += N) {
+            B b;
+            loadu(b, g + x);
+            const U p = __builtin_convertvector(b, U) * 0x010101;
+            if constexpr (F == pixel_format::rgb) {
+                store_rgb(d + x*3, p);
+            }
+            else {
+                const U a = p | 0xFF000000;
+                std::memcpy(d + x*4, &a, sizeof(U));
+            }
+        }
+        for (; x < width; ++x) {
+            std::memset(d + x * bpp<F>, g[x], 3);
+            if constexpr (bpp<F> == 4) d[x*4 + 3] = 255;
+        }
+    }
+}
+
+/// Converts packed pixels to planar I420: `width×height` Y, `⌈width/2⌉×⌈height/2⌉` U and V.
+///
+/// Example:
+/// ```c++
+/// const std::size_t cw = (w + 1) / 2, ch = (h + 1) / 2;
+/// std::vector<uint8_t> y(w*h), u(cw*ch), v(cw*ch);
+/// vx::image::to_i420<vx::image::pixel_format::rgb>(rgb, 3*w, y.data(), w, u.data(), cw, v.data(), cw, w, h);
+/// ```
+template <pixel_format F>
+void to_i420(const uint8_t* src, std::size_t src_stride,
+    uint8_t* y, std::size_t y_stride, uint8_t* u, std::size_t u_stride, uint8_t* v, std::size_t v_stride,
+    std::size_t width, std::size_t height)
+{
+    assert(v != nullptr);
+    detail::to_yuv420<F>(src, src_stride, y, y_stride, u, u_stride, v, v_stride, width, height);
+}
+
+/// Converts packed pixels to NV12: `width×height` Y, `⌈height/2⌉` rows of `⌈width/2⌉` U,V pairs.
+template <pixel_format F>
+void to_nv12(const uint8_t* src, std::size_t src_stride,
+    uint8_t* y, std::size_t y_stride, uint8_t* uv, std::size_t uv_stride,
+    std::size_t width, std::size_t height)
+{
+    detail::to_yuv420<F>(src, src_stride, y, y_stride, uv, uv_stride, nullptr, 0, width, height);
+}
+
+/// Converts planar I420 to packed pixels, alpha is 255.
+template <pixel_format F>
+void from_i420(const uint8_t* y, std::size_t y_stride, const uint8_t* u, std::size_t u_stride,
+    const uint8_t* v, std::size_t v_stride, uint8_t* dst, std::size_t dst_stride,
+    std::size_t width, std::size_t height)
+{
+    for (std::size_t r = 0; r < height; ++r) {
+        detail::rgb_row<F>(y + r*y_stride, u + r/2*u_stride, v + r/2*v_stride, dst + r*dst_stride, width);
+    }
+}
+
+/// Converts NV12 to packed pixels, alpha is 255.
+template <pixel_format F>
+void from_nv12(const uint8_t* y, std::size_t y_stride, const uint8_t* uv, std::size_t uv_stride,
+    uint8_t* dst, std::size_t dst_stride, std::size_t width, std::size_t height)
+{
+    for (std::size_t r = 0; r < height; ++r) {
+        detail::rgb_row<F>(y + r*y_stride, uv + r/2*uv_stride, nullptr, dst + r*dst_stride, width);
+    }
+}
+
+} // namespace vx::image
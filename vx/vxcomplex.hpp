@@ -6,9 +6,17 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <complex>
+#include <cstddef>
+#include <span>
+#include <utility>
+
 #include "vx/vxtypes.hpp"
 #include "vx/vxops.hpp"
 #include "vx/vxfun.hpp"
+#include "vx/vxmath.hpp"
 
 namespace vx::cx {
 
@@ -87,47 +95,216 @@ CV zero_vector()
 /// r1=a1,...  r2=a2,...
 /// i1=b1,...  i2=b2,...
 ///
-/// vk = r1[n]*r2[n], vm = r1[n]*i2[n]
 /// vl = i1[n]*i2[n], vn = r2[n]*i1[n]
-/// res_r = vk - vl, res_i = vm + vn
+/// res_r = r1[n]*r2[n] - vl, res_i = r1[n]*i2[n] + vn  (FMA)
 /// ```
 template <typename CV>
 CV mul(const CV& cv1, const CV& cv2)
 {
-    typename CV::type vk{vx::mul(cv1.real, cv2.real)};
-    typename CV::type vl{vx::mul(cv1.img,  cv2.img)};
-    typename CV::type vm{vx::mul(cv1.real, cv2.img)};
-    typename CV::type vn{vx::mul(cv1.img,  cv2.real)};
+    typename CV::type vl{vx::mul(cv1.img, cv2.img)};
+    typename CV::type vn{vx::mul(cv1.img, cv2.real)};
 
     CV res{
-        real: vx::sub(vk, vl),
-        img:  vx::add(vm, vn)};
+        real: vx::msub(cv1.real, cv2.real, vl),
+        img:  vx::madd(cv1.real, cv2.img,  vn)};
 
     return res;
 }
 
-//modulus
-// |a + bi| = sqrt(a^2 + b^2)
-/*template <typename CV>
-CV::type modulus(const CV& cv)
+/// `cv1 × cv2 + cv3` with four FMA, complex multiply-accumulate.
+template <typename CV>
+CV mul_add(const CV& cv1, const CV& cv2, const CV& cv3)
 {
-    typename CV::type r2{vx::mul(cv.real, cv.real)};
-    typename CV::type i2{vx::mul(cv.img,  cv.img)};
-    typename CV::type s{vx::sum(r2, i2)};
-    typename CV::type res{vx::sqrt(s)};
+    CV res{
+        real: vx::nmadd(cv1.img,  cv2.img,  vx::madd(cv1.real, cv2.real, cv3.real)),
+        img:  vx::madd(cv1.img,   cv2.real, vx::madd(cv1.real, cv2.img,  cv3.img))};
 
     return res;
-}*/
+}
+
+/// Multiplies real and imaginary parts by real scalar `s`.
+template <typename CV>
+CV mul_scalar(const CV& cv, const typename get_base<typename CV::type>::type s)
+{
+    const typename CV::type vs = broadcast<typename CV::type>(s);
+    return CV{real: vx::mul(cv.real, vs), img: vx::mul(cv.img, vs)};
+}
 
+/// `(a₁, b₁) / (a₂, b₂) = ((a₁a₂ + b₁b₂)/(a₂² + b₂²), (a₂b₁ − a₁b₂)/(a₂² + b₂²))`
+///
+/// Smith's algorithm: divides by the larger of `|a₂|`, `|b₂|` first
+/// instead of squaring, so the result does not overflow or underflow
+/// unless it is out of range itself. Division by zero gives NaN.
+///
+/// ```
+/// |a₂| >= |b₂|: r = b₂/a₂, d = a₂ + b₂r, ((a₁ + b₁r)/d, (b₁ − a₁r)/d)
+/// |a₂| <  |b₂|: r = a₂/b₂, d = a₂r + b₂, ((a₁r + b₁)/d, (b₁r − a₁)/d)
+/// ```
+template <typename CV>
+CV div(const CV& cv1, const CV& cv2)
+{
+    using V = typename CV::type;
+    const auto ge = vx::abs(cv2.real) >= vx::abs(cv2.img);
+    const V p = ge ? cv2.real : cv2.img, q = ge ? cv2.img : cv2.real;
+    const V u = ge ? cv1.real : cv1.img, v = ge ? cv1.img : cv1.real;
+    const V r = q / p;
+    const V d = vx::madd(q, r, p);
+    const V im = vx::nmadd(u, r, v) / d;
+
+    return CV{real: vx::madd(v, r, u) / d, img: ge ? im : -im};
+}
 
-//div
-//(a1,b1)/(a2,b2)=((a1a2 + b1b2)/(a2^2 + b2^2),(a2b1 - a1b2)/(a2^2 + b2^2))
+/// Modulus `|a + bi| = sqrt(a² + b²)`, with `vx::hypot` so large parts do not overflow.
+template <typename CV>
+typename CV::type modulus(const CV& cv)
+{
+    return vx::hypot(cv.real, cv.img);
+}
 
+/// Argument (phase angle) `atan2(b, a)` in `[-pi, pi]`.
+template <typename CV>
+typename CV::type arg(const CV& cv)
+{
+    return vx::atan2(cv.img, cv.real);
+}
 
-//cartesian2polar
+/// Polar form: modulus `r` and argument `phi`.
+template <typename CV>
+void cartesian2polar(const CV& cv, typename CV::type& r, typename CV::type& phi)
+{
+    r = modulus(cv);
+    phi = arg(cv);
+}
 
-//polar2cartesian
+/// Cartesian form `(r cos(phi), r sin(phi))`, accuracy of `vx::sincos`.
+///
+/// Example:
+/// ```c++
+/// auto z = vx::cx::polar2cartesian(amplitude, phase); // Complex<F32x8>
+/// ```
+template <accuracy A = accuracy::accurate, typename V>
+Complex<V> polar2cartesian(const V r, const V phi)
+{
+    V s, c;
+    vx::sincos<A>(phi, s, c);
+    return Complex<V>{real: r * c, img: r * s};
+}
 
-//mul_scalar
+/// Splits interleaved `(re, im)` pairs into `Complex<V>`,
+/// `lo` holds pairs `0..N/2-1` and `hi` pairs `N/2..N-1`.
+///
+/// Two two-source shuffles (`vpermt2ps` with AVX-512, `shufps` with SSE).
+template <typename V>
+Complex<V> deinterleave(const V lo, const V hi)
+{
+    Complex<V> cv;
+    deinterleave2(lo, hi, cv.real, cv.img);
+    return cv;
+}
+
+/// Merges `Complex<V>` into interleaved `(re, im)` pairs, inverse of `deinterleave`.
+template <typename V>
+void interleave(const Complex<V>& cv, V& lo, V& hi)
+{
+    interleave2(cv.real, cv.img, lo, hi);
+}
+
+/// Converts `std::complex<T>` array to split layout, `N = nrelem<V>()` numbers per `Complex<V>`.
+///
+/// `dst` holds `ceil(src.size()/N)` vectors, lanes past the end of `src` are zero.
+///
+/// Example:
+/// ```c++
+/// std::vector<std::complex<float>> samples(n);
+/// std::vector<vx::cx::Complex<F32x8>> split((n + 7) / 8);
+/// vx::cx::deinterleave<F32x8>(samples, split);
+/// ```
+template <typename V>
+void deinterleave(std::span<const std::complex<typename get_base<V>::type>> src, std::span<Complex<V>> dst)
+{
+    using T = typename get_base<V>::type;
+    using M = typename get_mask<V>::type;
+    constexpr std::size_t N = nrelem<V>();
+    assert(dst.size() == (src.size() + N - 1) / N);
+
+    // std::complex<T> is layout compatible with T[2]
+    const T* p = reinterpret_cast<const T*>(src.data());
+    const std::size_t n = src.size();
+    std::size_t i = 0;
+    for (; i + N <= n; i += N) {
+        V lo, hi;
+        loadu(lo, p + 2*i);
+        loadu(hi, p + 2*i + N);
+        dst[i / N] = deinterleave(lo, hi);
+    }
+    if (i < n) {
+        const std::size_t rest = 2 * (n - i);
+        V lo{}, hi{};
+        maskload(lo, p + 2*i, mask_first_n<M>(std::min(rest, N)));
+        if (rest > N) maskload(hi, p + 2*i + N, mask_first_n<M>(rest - N));
+        dst[i / N] = deinterleave(lo, hi);
+    }
+}
+
+/// Converts split layout back to `std::complex<T>` array of `dst.size()` numbers,
+/// `src` holds `ceil(dst.size()/N)` vectors.
+template <typename V>
+void interleave(std::span<const Complex<V>> src, std::span<std::complex<typename get_base<V>::type>> dst)
+{
+    using T = typename get_base<V>::type;
+    using M = typename get_mask<V>::type;
+    constexpr std::size_t N = nrelem<V>();
+    assert(src.size() == (dst.size() + N - 1) / N);
+
+    T* p = reinterpret_cast<T*>(dst.data());
+    const std::size_t n = dst.size();
+    std::size_t i = 0;
+    for (; i + N <= n; i += N) {
+        V lo, hi;
+        interleave(src[i / N], lo, hi);
+        storeu(p + 2*i, lo);
+        storeu(p + 2*i + N, hi);
+    }
+    if (i < n) {
+        const std::size_t rest = 2 * (n - i);
+        V lo, hi;
+        interleave(src[i / N], lo, hi);
+        maskstore(p + 2*i, lo, mask_first_n<M>(std::min(rest, N)));
+        if (rest > N) maskstore(p + 2*i + N, hi, mask_first_n<M>(rest - N));
+    }
+}
+
+/// Complex product of interleaved `(re, im)` pairs, `a[k] * b[k]` for every pair.
+///
+/// `fmaddsub(a, dup(b.re), swap(a) * dup(b.im))`:
+/// `(a.re b.re − a.im b.im, a.im b.re + a.re b.im)`,
+/// for data kept as `std::complex<T>` without conversion to split layout.
+template <typename V>
+V mul_interleaved(const V a, const V b)
+{
+    constexpr auto dup_re = lane_mask<V>([](std::size_t j) {return j & ~std::size_t{1};});
+    constexpr auto dup_im = lane_mask<V>([](std::size_t j) {return j | 1;});
+    constexpr auto swap   = lane_mask<V>([](std::size_t j) {return j ^ 1;});
+    const V t = __builtin_shuffle(a, swap) * __builtin_shuffle(b, dup_im);
+    return vx::fmaddsub(a, __builtin_shuffle(b, dup_re), t);
+}
+
+/// `a[k] * conj(b[k])` for interleaved `(re, im)` pairs.
+template <typename V>
+V mul_conj_interleaved(const V a, const V b)
+{
+    constexpr auto dup_re = lane_mask<V>([](std::size_t j) {return j & ~std::size_t{1};});
+    constexpr auto dup_im = lane_mask<V>([](std::size_t j) {return j | 1;});
+    constexpr auto swap   = lane_mask<V>([](std::size_t j) {return j ^ 1;});
+    const V t = __builtin_shuffle(a, swap) * __builtin_shuffle(b, dup_im);
+    return vx::fmsubadd(a, __builtin_shuffle(b, dup_re), t);
+}
+
+/// Conjugates interleaved `(re, im)` pairs.
+template <typename V>
+V conj_interleaved(const V a)
+{
+    return vx::negate_alternate<true>(a);
+}
 
 } //namespace vx::cx
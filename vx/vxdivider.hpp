@@ -0,0 +1,130 @@
+/**@file
+ * @brief     Vector integer division by runtime-invariant divisor.
+ * @author    Igor Lesik 2021
+ * @copyright Igor Lesik 2021
+ *
+ * GCC lowers `/` and `%` of integer vectors to scalar `div` per element.
+ * `vx::divider` computes multiply-high magic number and shift once
+ * (Granlund-Montgomery, as in libdivide), then division is `mulhi`,
+ * add and shifts on whole vectors.
+ *
+ * Example:
+ * ```c++
+ * const vx::divider<uint32_t> buckets(nr_buckets);
+ * U32x16 b = hash % buckets; // buckets.modulo(hash)
+ * ```
+ */
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "vx/vxtypes.hpp"
+#include "vx/vxops.hpp"
+
+namespace vx {
+
+/// Divisor of U32/I32/U64/I64 vector elements, quotient rounds toward zero like `/`.
+///
+/// Unsigned `n/d` is `mulhi(n, m) >> s`, or `(((n - t) >> 1) + t) >> s`
+/// with `t = mulhi(n, m)` when magic `m` needs one more bit than `T` has;
+/// powers of two are a single shift. Signed division uses magic number
+/// of `|d|` with sign fix-ups. Dividing `INT_MIN` by `-1` overflows as `/` does.
+template <typename T>
+class divider
+{
+    static_assert(std::is_integral_v<T> and (sizeof(T) == 4 or sizeof(T) == 8));
+
+    using UT = std::make_unsigned_t<T>;
+    using WT = std::conditional_t<sizeof(T) == 4, uint64_t, unsigned __int128>;
+    static constexpr unsigned bits = sizeof(T) * 8;
+
+    T d_;          ///< divisor
+    T magic_ = 0;  ///< 0 for powers of two
+    unsigned shift_ = 0;
+    bool add_ = false;
+
+public:
+    explicit divider(const T d) : d_(d)
+    {
+        assert(d != 0);
+        const bool neg = std::is_signed_v<T> and d < 0;
+        const UT ad = neg ? (UT)0 - (UT)d : (UT)d;
+        const unsigned l = std::bit_width(ad) - 1; // floor(log2(|d|))
+        shift_ = l;
+        if ((ad & (ad - 1)) == 0) {
+            return;
+        }
+        // m = 2^(bits+l)/|d| for unsigned, 2^(bits+l-1)/|d| for signed, rounded up
+        const unsigned p = std::is_signed_v<T> ? l - 1 : l;
+        const WT num = (WT)1 << (bits + p);
+        UT m = (UT)(num / ad);
+        const UT rem = (UT)(num % ad);
+        if (ad - rem < ((UT)1 << l)) {
+            shift_ = p;
+        }
+        else {
+            m += m;
+            const UT twice_rem = rem + rem;
+            if (twice_rem >= ad or twice_rem < rem) m += 1;
+            add_ = true;
+        }
+        m += 1;
+        magic_ = neg ? (T)((UT)0 - m) : (T)m;
+    }
+
+    T divisor() const {return d_;}
+
+    /// Quotient `n[i] / d`.
+    template <typename V>
+    V divide(const V n) const
+    {
+        static_assert(std::is_same_v<typename get_base<V>::type, T>);
+        using U = typename make<UT, nrelem<V>()>::type;
+
+        if constexpr (std::is_unsigned_v<T>) {
+            if (magic_ == 0) return n >> shift_;
+            const V t = mulhi(n, (V){} + magic_);
+            return add_ ? (((n - t) >> 1) + t) >> shift_ : t >> shift_;
+        }
+        else {
+            if (magic_ == 0) {
+                V q = n;
+                if (shift_) {
+                    // round toward zero: add |d|-1 to negative n before arithmetic shift
+                    q = (n + (V)((U)(n >> (bits - 1)) >> (bits - shift_))) >> shift_;
+                }
+                return d_ < 0 ? -q : q;
+            }
+            V q = mulhi(n, (V){} + magic_);
+            if (add_) q += d_ < 0 ? -n : n;
+            q >>= shift_;
+            return q - (q >> (bits - 1)); // +1 for negative
+        }
+    }
+
+    /// Remainder `n[i] % d`, sign of `n` for signed types.
+    template <typename V>
+    V modulo(const V n) const {return n - divide(n) * d_;}
+
+    /// Quotient and remainder at once.
+    template <typename V>
+    void divmod(const V n, V& q, V& r) const
+    {
+        q = divide(n);
+        r = n - q * d_;
+    }
+};
+
+/// `n / d` for vector `n`.
+template <typename V, typename T>
+V operator/(const V n, const divider<T>& d) {return d.divide(n);}
+
+/// `n % d` for vector `n`.
+template <typename V, typename T>
+V operator%(const V n, const divider<T>& d) {return d.modulo(n);}
+
+} // namespace vx
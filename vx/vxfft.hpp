@@ -0,0 +1,545 @@
+/**@file
+ * @brief     Fast Fourier transform on split complex layout.
+ * @author    Igor Lesik 2021
+ * @copyright Igor Lesik 2021
+ *
+ * Complex data is split like `vx::cx::Complex`: real parts in one array,
+ * imaginary parts in another, so vector lanes hold independent elements
+ * and butterflies are plain vector add/mul/FMA with no in-register swizzles.
+ *
+ * Transform is mixed-radix Stockham autosort (no bit reversal pass),
+ * decimation in frequency, radix 8, 4, 2, 3, 5 kernels and O(p²) kernel
+ * for other prime factors. Sizes divisible by `N²` for vector width `N`
+ * use four-step algorithm: `n/N`-point FFTs of `N` interleaved columns
+ * on whole vectors, twiddle, `N×N` register transposes and `N`-point FFTs
+ * across lanes. Other sizes run the same stages on scalars, except stages
+ * with stride multiple of vector width which are vectorized along the stride.
+ *
+ * Transforms are unnormalized like FFTW: `inverse(forward(x)) == n*x`.
+ *
+ * Example:
+ * ```c++
+ * vx::fft::plan<float> p(1024);
+ * p.forward(re, im); // std::span<float>, in place, size multiple of 1024 for batch
+ * ```
+ */
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "vx/vxtypes.hpp"
+#include "vx/vxops.hpp"
+#include "vx/vxfun.hpp"
+#include "vx/vxcomplex.hpp"
+
+namespace vx::fft {
+
+namespace detail {
+
+/// Element `E` is scalar `T` or vector of `T`.
+template <typename E> using cplx = cx::Complex<E>;
+
+template <typename E>
+constexpr std::size_t width()
+{
+    if constexpr (std::is_floating_point_v<E>) return 1; else return nrelem<E>();
+}
+
+template <typename E, typename T>
+E ld(const T* p, std::size_t i)
+{
+    if constexpr (std::is_floating_point_v<E>) {
+        return p[i];
+    }
+    else {
+        E v;
+        loadu(v, p + i * width<E>());
+        return v;
+    }
+}
+
+template <typename E, typename T>
+void st(T* p, std::size_t i, const E v)
+{
+    if constexpr (std::is_floating_point_v<E>) p[i] = v; else storeu(p + i * width<E>(), v);
+}
+
+template <typename E>
+cplx<E> ld(const auto* re, const auto* im, std::size_t i) {return {ld<E>(re, i), ld<E>(im, i)};}
+
+template <typename E>
+void st(auto* re, auto* im, std::size_t i, const cplx<E>& v) {st(re, i, v.real); st(im, i, v.img);}
+
+/// All elements set to `v`.
+template <typename E, typename T>
+E splat(const T v)
+{
+    if constexpr (std::is_floating_point_v<E>) return v; else return broadcast<E>(v);
+}
+
+/// `vx::madd` and friends, plain arithmetic for scalar element.
+template <typename E> E madd(const E a, const E b, const E c) {if constexpr (std::is_floating_point_v<E>) return a * b + c; else return vx::madd(a, b, c);}
+template <typename E> E msub(const E a, const E b, const E c) {if constexpr (std::is_floating_point_v<E>) return a * b - c; else return vx::msub(a, b, c);}
+template <typename E> E nmadd(const E a, const E b, const E c) {if constexpr (std::is_floating_point_v<E>) return c - a * b; else return vx::nmadd(a, b, c);}
+
+template <typename E> cplx<E> operator+(const cplx<E>& a, const cplx<E>& b) {return {a.real + b.real, a.img + b.img};}
+template <typename E> cplx<E> operator-(const cplx<E>& a, const cplx<E>& b) {return {a.real - b.real, a.img - b.img};}
+
+/// `a * w`
+template <typename E>
+cplx<E> mul(const cplx<E>& a, const cplx<E>& w)
+{
+    return {msub(a.real, w.real, a.img * w.img), madd(a.real, w.img, a.img * w.real)};
+}
+
+/// `-i * a`
+template <typename E> cplx<E> mul_ni(const cplx<E>& a) {return {a.img, -a.real};}
+
+/// Forward DFT of `R` points, `b[j] = ∑ a[k] e^(-2πi jk/R)`.
+template <unsigned R, typename E, typename T>
+__attribute__((always_inline)) inline void dft(const cplx<E> (&a)[R], cplx<E> (&b)[R])
+{
+    if constexpr (R == 2) {
+        b[0] = a[0] + a[1];
+        b[1] = a[0] - a[1];
+    }
+    else if constexpr (R == 3) {
+        const E h = splat<E>((T)0.5), s3 = splat<E>((T)0.866025403784438646763723170752936183L);
+        const cplx<E> t = a[1] + a[2], d = a[1] - a[2];
+        const cplx<E> m = {nmadd(t.real, h, a[0].real), nmadd(t.img, h, a[0].img)};
+        b[0] = a[0] + t;
+        b[1] = {madd(d.img, s3, m.real), nmadd(d.real, s3, m.img)};
+        b[2] = {nmadd(d.img, s3, m.real), madd(d.real, s3, m.img)};
+    }
+    else if constexpr (R == 4) {
+        const cplx<E> t0 = a[0] + a[2], t1 = a[0] - a[2];
+        const cplx<E> t2 = a[1] + a[3], t3 = mul_ni(a[1] - a[3]);
+        b[0] = t0 + t2;
+        b[1] = t1 + t3;
+        b[2] = t0 - t2;
+        b[3] = t1 - t3;
+    }
+    else if constexpr (R == 5) {
+        const E c1 = splat<E>((T)0.309016994374947424102293417182819059L);  // cos(2π/5)
+        const E c2 = splat<E>((T)-0.809016994374947424102293417182819059L); // cos(4π/5)
+        const E s1 = splat<E>((T)0.951056516295153572116439333379382143L);  // sin(2π/5)
+        const E s2 = splat<E>((T)0.587785252292473129168705954639072769L);  // sin(4π/5)
+        const cplx<E> t1 = a[1] + a[4], t2 = a[2] + a[3];
+        const cplx<E> d1 = a[1] - a[4], d2 = a[2] - a[3];
+        const cplx<E> m1 = {madd(c2, t2.real, madd(c1, t1.real, a[0].real)), madd(c2, t2.img, madd(c1, t1.img, a[0].img))};
+        const cplx<E> m2 = {madd(c1, t2.real, madd(c2, t1.real, a[0].real)), madd(c1, t2.img, madd(c2, t1.img, a[0].img))};
+        const cplx<E> n1 = mul_ni(cplx<E>{madd(s1, d1.real, s2 * d2.real), madd(s1, d1.img, s2 * d2.img)});
+        const cplx<E> n2 = mul_ni(cplx<E>{msub(s2, d1.real, s1 * d2.real), msub(s2, d1.img, s1 * d2.img)});
+        b[0] = a[0] + t1 + t2;
+        b[1] = m1 + n1;
+        b[4] = m1 - n1;
+        b[2] = m2 + n2;
+        b[3] = m2 - n2;
+    }
+    else if constexpr (R == 8) {
+        // two DFT4 of even and odd points, combined with powers of e^(-iπ/4)
+        const E c = splat<E>((T)0.707106781186547524400844362104849039L);
+        const cplx<E> ev[4] = {a[0], a[2], a[4], a[6]}, od[4] = {a[1], a[3], a[5], a[7]};
+        cplx<E> e[4], o[4];
+        dft<4, E, T>(ev, e);
+        dft<4, E, T>(od, o);
+        o[1] = {(o[1].real + o[1].img) * c, (o[1].img - o[1].real) * c};
+        o[2] = mul_ni(o[2]);
+        o[3] = {(o[3].img - o[3].real) * c, -(o[3].real + o[3].img) * c};
+        unroll<4>([&](std::size_t k) {
+            b[k] = e[k] + o[k];
+            b[k + 4] = e[k] - o[k];
+        });
+    }
+}
+
+/// One pass of Stockham DIF: `L = R*m` point transforms, stride `s`.
+struct stage
+{
+    unsigned r;
+    std::size_t m, s;
+    std::size_t tw; ///< offset of `w_L^(p*j)`, `p < m`, `0 < j < r`
+    std::size_t om; ///< offset of `w_r^k` for generic radix
+};
+
+template <unsigned R, typename E, typename T>
+void pass(const stage& sg, const T* twr, const T* twi, const T* xr, const T* xi, T* yr, T* yi)
+{
+    const std::size_t m = sg.m, s = sg.s;
+    for (std::size_t p = 0; p < m; ++p) {
+        cplx<E> w[R];
+        unroll<R-1>([&](std::size_t j) {
+            w[j+1] = {splat<E>(twr[sg.tw + p*(R-1) + j]), splat<E>(twi[sg.tw + p*(R-1) + j])};
+        });
+        for (std::size_t q = 0; q < s; ++q) {
+            cplx<E> a[R], b[R];
+            unroll<R>([&](std::size_t k) {a[k] = ld<E>(xr, xi, q + s*(p + k*m));});
+            dft<R, E, T>(a, b);
+            const std::size_t o = q + s*R*p;
+            st<E>(yr, yi, o, b[0]);
+            unroll<R-1>([&](std::size_t j) {st<E>(yr, yi, o + s*(j+1), mul(b[j+1], w[j+1]));});
+        }
+    }
+}
+
+template <typename E, typename T>
+void pass_generic(const stage& sg, const T* twr, const T* twi, const T* xr, const T* xi, T* yr, T* yi)
+{
+    const std::size_t r = sg.r, m = sg.m, s = sg.s;
+    for (std::size_t p = 0; p < m; ++p) {
+        for (std::size_t q = 0; q < s; ++q) {
+            for (std::size_t j = 0; j < r; ++j) {
+                cplx<E> acc = ld<E>(xr, xi, q + s*p);
+                for (std::size_t k = 1, jk = j; k < r; ++k, jk = (jk + j) % r) {
+                    const cplx<E> w = {splat<E>(twr[sg.om + jk]), splat<E>(twi[sg.om + jk])};
+                    const cplx<E> a = ld<E>(xr, xi, q + s*(p + k*m));
+                    acc = {madd(a.real, w.real, nmadd(a.img, w.img, acc.real)), madd(a.real, w.img, madd(a.img, w.real, acc.img))};
+                }
+                if (j) {
+                    const std::size_t t = sg.tw + p*(r-1) + j-1;
+                    acc = mul(acc, cplx<E>{splat<E>(twr[t]), splat<E>(twi[t])});
+                }
+                st<E>(yr, yi, q + s*(r*p + j), acc);
+            }
+        }
+    }
+}
+
+template <typename E, typename T>
+void run_stage(const stage& sg, const T* twr, const T* twi, const T* xr, const T* xi, T* yr, T* yi)
+{
+    switch (sg.r) {
+    case 2: pass<2, E>(sg, twr, twi, xr, xi, yr, yi); break;
+    case 3: pass<3, E>(sg, twr, twi, xr, xi, yr, yi); break;
+    case 4: pass<4, E>(sg, twr, twi, xr, xi, yr, yi); break;
+    case 5: pass<5, E>(sg, twr, twi, xr, xi, yr, yi); break;
+    case 8: pass<8, E>(sg, twr, twi, xr, xi, yr, yi); break;
+    default: pass_generic<E>(sg, twr, twi, xr, xi, yr, yi); break;
+    }
+}
+
+/// Scalar stage with stride `s` divisible by width `N` of `V` is the same stage
+/// on vectors with stride `s/N`: runs it on the widest such vector.
+template <typename V, typename T>
+bool run_stage_vec(const stage& sg, const T* twr, const T* twi, const T* xr, const T* xi, T* yr, T* yi)
+{
+    constexpr std::size_t N = nrelem<V>();
+    if (sg.s % N == 0) {
+        stage vs = sg;
+        vs.s /= N;
+        run_stage<V>(vs, twr, twi, xr, xi, yr, yi);
+        return true;
+    }
+    if constexpr (N * sizeof(T) > 16) {
+        return run_stage_vec<typename make<T, N/2>::type>(sg, twr, twi, xr, xi, yr, yi);
+    }
+    else {
+        return false;
+    }
+}
+
+/// Runs all stages from `x` to `y`, `tmp` holds every other intermediate result.
+/// Each stage reads and writes different arrays, so `x` must not be `y`.
+template <typename E, typename T>
+void run(const std::vector<stage>& stages, const T* twr, const T* twi,
+         const T* xr, const T* xi, T* yr, T* yi, T* tr, T* ti)
+{
+    const std::size_t last = stages.size() - 1;
+    for (std::size_t i = 0; i <= last; ++i) {
+        const stage& sg = stages[i];
+        T* dr = (last - i) % 2 ? tr : yr;
+        T* di = (last - i) % 2 ? ti : yi;
+        if constexpr (std::is_floating_point_v<E>) {
+            if (!run_stage_vec<native<T>>(sg, twr, twi, xr, xi, dr, di)) run_stage<E>(sg, twr, twi, xr, xi, dr, di);
+        }
+        else {
+            run_stage<E>(sg, twr, twi, xr, xi, dr, di);
+        }
+        xr = dr;
+        xi = di;
+    }
+}
+
+/// `e^(-2πi k/n)` in long double, `k < n`.
+template <typename T>
+void twiddle(std::size_t k, std::size_t n, std::vector<T>& re, std::vector<T>& im)
+{
+    const long double pi = 3.141592653589793238462643383279502884L;
+    const long double a = -2 * pi * (long double)k / (long double)n;
+    re.push_back((T)std::cos(a));
+    im.push_back((T)std::sin(a));
+}
+
+/// Factors `n` into radices 8, 4, 2, 3, 5 and other primes, builds stages and their twiddles.
+template <typename T>
+std::vector<stage> make_stages(std::size_t n, std::vector<T>& twr, std::vector<T>& twi)
+{
+    std::vector<unsigned> radix;
+    std::size_t k = n;
+    for (unsigned r : {8u, 4u, 2u, 3u, 5u}) {
+        while (k % r == 0) { radix.push_back(r); k /= r; }
+    }
+    for (std::size_t p = 7; k > 1; p += 2) {
+        while (k % p == 0) { radix.push_back((unsigned)p); k /= p; }
+    }
+
+    std::vector<stage> stages;
+    std::size_t L = n, s = 1;
+    for (unsigned r : radix) {
+        const std::size_t m = L / r;
+        stage sg{r, m, s, twr.size(), 0};
+        for (std::size_t p = 0; p < m; ++p) {
+            for (std::size_t j = 1; j < r; ++j) twiddle((p * j) % L, L, twr, twi);
+        }
+        if (r != 2 and r != 3 and r != 4 and r != 5 and r != 8) {
+            sg.om = twr.size();
+            for (std::size_t j = 0; j < r; ++j) twiddle(j, r, twr, twi);
+        }
+        stages.push_back(sg);
+        L = m;
+        s *= r;
+    }
+    return stages;
+}
+
+} // namespace detail
+
+/// Plan of complex FFT of size `n` for F32 or F64, caches twiddles and scratch buffers.
+///
+/// Transforms work in place on split real/imaginary arrays, arrays longer
+/// than `n` are a batch of consecutive transforms. Plan is reused for many
+/// transforms but not by two threads at once (scratch), use one plan per thread.
+template <typename T>
+class plan
+{
+    static_assert(std::is_floating_point_v<T>);
+
+    std::size_t n_;
+    std::size_t lanes_ = 0; ///< vector width `N` of four-step path, 0 for scalar stages
+    std::vector<detail::stage> stages_;      ///< `n` or `n/N` points
+    std::vector<detail::stage> lane_stages_; ///< `N` points
+    std::vector<T> twr_, twi_;               ///< stage twiddles
+    std::vector<T> stepr_, stepi_;           ///< `w_n^(j1*k2)` at `[k2][j1]`
+    std::vector<T> buf_;
+
+    template <typename V>
+    void four_step(T* re, T* im)
+    {
+        constexpr std::size_t N = nrelem<V>();
+        const std::size_t n2 = n_ / N;
+        T* yr = buf_.data();
+        T* yi = yr + n_;
+        const T* twr = twr_.data();
+        const T* twi = twi_.data();
+
+        // n2-point transforms of columns j1, elements x[j1 + N*j2] as vectors
+        detail::run<V>(stages_, twr, twi, re, im, yr, yi, yi + n_, yi + 2*n_);
+
+        for (std::size_t b = 0; b < n2; b += N) {
+            V r[N], i[N];
+            for (std::size_t k = 0; k < N; ++k) {
+                const std::size_t k2 = b + k;
+                const detail::cplx<V> y = detail::ld<V>(yr, yi, k2);
+                const detail::cplx<V> w = detail::ld<V>(stepr_.data(), stepi_.data(), k2);
+                const detail::cplx<V> t = detail::mul(y, w);
+                r[k] = t.real;
+                i[k] = t.img;
+            }
+            transpose(r);
+            transpose(i);
+
+            // N-point transforms across lanes, lanes are k2 = b..b+N-1
+            alignas(V) T xr[N*N], xi[N*N], zr[N*N], zi[N*N], tr[N*N], ti[N*N];
+            for (std::size_t j1 = 0; j1 < N; ++j1) {
+                store(xr + j1*N, r[j1]);
+                store(xi + j1*N, i[j1]);
+            }
+            detail::run<V>(lane_stages_, twr, twi, xr, xi, zr, zi, tr, ti);
+            for (std::size_t k1 = 0; k1 < N; ++k1) {
+                V v;
+                load(v, zr + k1*N); storeu(re + n2*k1 + b, v);
+                load(v, zi + k1*N); storeu(im + n2*k1 + b, v);
+            }
+        }
+    }
+
+    void scalar(T* re, T* im)
+    {
+        if (n_ == 1) return;
+        T* yr = buf_.data();
+        T* yi = yr + n_;
+        detail::run<T>(stages_, twr_.data(), twi_.data(), re, im, yr, yi, yi + n_, yi + 2*n_);
+        std::copy(yr, yr + n_, re);
+        std::copy(yi, yi + n_, im);
+    }
+
+    void transform(T* re, T* im)
+    {
+        constexpr std::size_t native_lanes = nrelem<native<T>>();
+        switch (lanes_) {
+        case 16: if constexpr (native_lanes >= 16) four_step<typename make<T,16>::type>(re, im); break;
+        case 8:  if constexpr (native_lanes >= 8)  four_step<typename make<T,8>::type>(re, im);  break;
+        case 4:  if constexpr (native_lanes >= 4)  four_step<typename make<T,4>::type>(re, im);  break;
+        case 2:  if constexpr (sizeof(T) == 8)     four_step<typename make<T,2>::type>(re, im);  break;
+        default: scalar(re, im); break;
+        }
+    }
+
+public:
+    explicit plan(const std::size_t n) : n_(n)
+    {
+        assert(n > 0);
+        constexpr std::size_t min_lanes = 16 / sizeof(T);
+        for (std::size_t N = nrelem<native<T>>(); N >= min_lanes; N /= 2) {
+            if (n % (N * N) == 0) {
+                lanes_ = N;
+                break;
+            }
+        }
+
+        const std::size_t nc = lanes_ ? n / lanes_ : n;
+        if (nc > 1) stages_ = detail::make_stages(nc, twr_, twi_);
+        if (lanes_) {
+            lane_stages_ = detail::make_stages(lanes_, twr_, twi_);
+            for (std::size_t k2 = 0; k2 < nc; ++k2) {
+                for (std::size_t j1 = 0; j1 < lanes_; ++j1) detail::twiddle(j1 * k2, n, stepr_, stepi_);
+            }
+        }
+        buf_.resize(4 * n);
+    }
+
+    std::size_t size() const {return n_;}
+
+    /// Forward transform `X[k] = ∑ x[j] e^(-2πi jk/n)` in place.
+    void forward(std::span<T> re, std::span<T> im)
+    {
+        assert(re.size() == im.size() and re.size() % n_ == 0);
+        for (std::size_t i = 0; i < re.size(); i += n_) transform(re.data() + i, im.data() + i);
+    }
+
+    /// Inverse transform `x[j] = ∑ X[k] e^(2πi jk/n)` in place, not divided by `n`.
+    void inverse(std::span<T> re, std::span<T> im)
+    {
+        // swapping real and imaginary parts conjugates and multiplies by i
+        forward(im, re);
+    }
+};
+
+/// Plan of FFT of `n` real numbers, output is `n/2+1` bins `X[0..n/2]`
+/// (the rest is `X[n-k] = conj(X[k])`).
+///
+/// Even `n` packs `x[2j] + i*x[2j+1]` into `n/2`-point complex transform
+/// and untangles even and odd halves with `w_n^k`. Odd `n` runs full complex transform.
+template <typename T>
+class real_plan
+{
+    std::size_t n_;
+    plan<T> plan_;
+    std::vector<T> twr_, twi_; ///< `w_n^k`, `k <= n/4`
+    std::vector<T> buf_;
+
+public:
+    explicit real_plan(const std::size_t n) : n_(n), plan_(n % 2 ? n : n / 2)
+    {
+        assert(n > 0);
+        if (n % 2 == 0) {
+            for (std::size_t k = 0; k <= n / 4; ++k) detail::twiddle(k, n, twr_, twi_);
+        }
+        buf_.resize(2 * plan_.size());
+    }
+
+    std::size_t size() const {return n_;}
+
+    /// Number of output bins `n/2+1`.
+    std::size_t bins() const {return n_ / 2 + 1;}
+
+    /// Forward transform of `x`, batch of `x.size()/n` transforms writes `bins()` bins each.
+    void forward(std::span<const T> x, std::span<T> re, std::span<T> im)
+    {
+        const std::size_t nb = bins(), h = plan_.size();
+        assert(x.size() % n_ == 0 and re.size() == x.size() / n_ * nb and im.size() == re.size());
+        T* zr = buf_.data();
+        T* zi = zr + h;
+        for (std::size_t b = 0; b < x.size() / n_; ++b) {
+            const T* xb = x.data() + b * n_;
+            T* Xr = re.data() + b * nb;
+            T* Xi = im.data() + b * nb;
+            if (n_ % 2) {
+                std::copy(xb, xb + n_, zr);
+                std::fill(zi, zi + n_, T{});
+                plan_.forward(std::span<T>(zr, h), std::span<T>(zi, h));
+                std::copy(zr, zr + nb, Xr);
+                std::copy(zi, zi + nb, Xi);
+                continue;
+            }
+            for (std::size_t j = 0; j < h; ++j) {
+                zr[j] = xb[2*j];
+                zi[j] = xb[2*j + 1];
+            }
+            plan_.forward(std::span<T>(zr, h), std::span<T>(zi, h));
+
+            Xr[0] = zr[0] + zi[0]; Xi[0] = 0;
+            Xr[h] = zr[0] - zi[0]; Xi[h] = 0;
+            for (std::size_t k = 1; k <= h / 2; ++k) {
+                const std::size_t m = h - k;
+                // Fe = (Z[k] + conj Z[m])/2, Fo = -i/2 (Z[k] - conj Z[m])
+                const T er = (zr[k] + zr[m]) / 2, ei = (zi[k] - zi[m]) / 2;
+                const T fr = (zi[k] + zi[m]) / 2, fi = (zr[m] - zr[k]) / 2;
+                const T wr = twr_[k], wi = twi_[k];
+                const T tr = fr * wr - fi * wi, ti = fr * wi + fi * wr;
+                Xr[k] = er + tr; Xi[k] = ei + ti;
+                Xr[m] = er - tr; Xi[m] = ti - ei;
+            }
+        }
+    }
+
+    /// Inverse transform of `bins()` bins per batch element to `n` real numbers, not divided by `n`.
+    void inverse(std::span<const T> re, std::span<const T> im, std::span<T> x)
+    {
+        const std::size_t nb = bins(), h = plan_.size();
+        assert(x.size() % n_ == 0 and re.size() == x.size() / n_ * nb and im.size() == re.size());
+        T* zr = buf_.data();
+        T* zi = zr + h;
+        for (std::size_t b = 0; b < x.size() / n_; ++b) {
+            const T* Xr = re.data() + b * nb;
+            const T* Xi = im.data() + b * nb;
+            T* xb = x.data() + b * n_;
+            if (n_ % 2) {
+                zr[0] = Xr[0]; zi[0] = 0;
+                for (std::size_t k = 1; k < nb; ++k) {
+                    zr[k] = Xr[k]; zi[k] = Xi[k];
+                    zr[n_ - k] = Xr[k]; zi[n_ - k] = -Xi[k];
+                }
+                plan_.inverse(std::span<T>(zr, h), std::span<T>(zi, h));
+                std::copy(zr, zr + n_, xb);
+                continue;
+            }
+            zr[0] = Xr[0] + Xr[h];
+            zi[0] = Xr[0] - Xr[h];
+            for (std::size_t k = 1; k <= h / 2; ++k) {
+                const std::size_t m = h - k;
+                // Fe = X[k] + conj X[m], Fo = (X[k] - conj X[m]) conj(w^k), Z = Fe + i Fo
+                const T er = Xr[k] + Xr[m], ei = Xi[k] - Xi[m];
+                const T dr = Xr[k] - Xr[m], di = Xi[k] + Xi[m];
+                const T wr = twr_[k], wi = twi_[k];
+                const T fr = dr * wr + di * wi, fi = di * wr - dr * wi;
+                zr[k] = er - fi; zi[k] = ei + fr;
+                zr[m] = er + fi; zi[m] = fr - ei;
+            }
+            plan_.inverse(std::span<T>(zr, h), std::span<T>(zi, h));
+            for (std::size_t j = 0; j < h; ++j) {
+                xb[2*j] = zr[j];
+                xb[2*j + 1] = zi[j];
+            }
+        }
+    }
+};
+
+} // namespace vx::fft
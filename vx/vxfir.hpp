@@ -0,0 +1,337 @@
+/**@file
+ * @brief     FIR filter, convolution and correlation.
+ * @author    Igor Lesik 2021
+ * @copyright Igor Lesik 2021
+ *
+ * F32/F64 and Q15 (`int16_t`) samples.
+ *
+ * Direct kernel computes a tile of output vectors at once: every tap is
+ * broadcast once and multiplied with unaligned loads of the input
+ * shifted by the tap index into independent FMA accumulators.
+ * Q15 tiles use `pmaddwd` on pairs of taps with 32-bit accumulators,
+ * even outputs in one vector and odd outputs in another, so the results
+ * pack back to 16 bits without shuffles.
+ *
+ * Floating point kernels with at least `fir_fft_taps` taps use overlap-save
+ * FFT convolution (`vx/vxfft.hpp`), cost per output is O(log taps)
+ * instead of O(taps).
+ */
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "vx/vxtypes.hpp"
+#include "vx/vxops.hpp"
+#include "vx/vxfun.hpp"
+#include "vx/vxcomplex.hpp"
+#include "vx/vxfft.hpp"
+
+namespace vx {
+
+/// Number of taps from which floating point filters switch to FFT convolution,
+/// measured break-even point of F32 and F64 with AVX-512.
+inline constexpr std::size_t fir_fft_taps = 128;
+
+namespace detail {
+
+/// Valid cross-correlation `y[i] = ∑ x[i+j]*h[j]`, `j < m`, `i < ny`,
+/// `x` holds `ny + m - 1` samples.
+template <typename T>
+void correlate_direct(const T* x, const T* h, std::size_t m, T* y, std::size_t ny)
+{
+    using V = native<T>;
+    using M = typename get_mask<V>::type;
+    constexpr std::size_t N = nrelem<V>();
+    constexpr std::size_t R = 8; // output vectors per tile
+
+    std::size_t i = 0;
+    for (; i + R*N <= ny; i += R*N) {
+        V acc[R] = {};
+        for (std::size_t j = 0; j < m; ++j) {
+            const V hj = broadcast<V>(h[j]);
+            vx::unroll<R>([&](std::size_t r) {
+                V xv;
+                loadu(xv, x + i + r*N + j);
+                acc[r] = madd(xv, hj, acc[r]);
+            });
+        }
+        vx::unroll<R>([&](std::size_t r) {storeu(y + i + r*N, acc[r]);});
+    }
+    // one chain in taps order like the tile above, so every output is the
+    // same whichever loop computes it and does not depend on block splits
+    for (; i + N <= ny; i += N) {
+        V acc{};
+        for (std::size_t j = 0; j < m; ++j) {
+            V xv;
+            loadu(xv, x + i + j);
+            acc = madd(xv, broadcast<V>(h[j]), acc);
+        }
+        storeu(y + i, acc);
+    }
+    if (i < ny) {
+        // x[i+j+k] with k < ny-i is in range for every tap
+        const M mask = mask_first_n<M>(ny - i);
+        V acc{};
+        for (std::size_t j = 0; j < m; ++j) {
+            V xv{};
+            maskload(xv, x + i + j, mask);
+            acc = madd(xv, broadcast<V>(h[j]), acc);
+        }
+        maskstore(y + i, acc, mask);
+    }
+}
+
+/// Tile of `R` Q15 output vectors starting at `x`, `hp` holds pairs of taps
+/// `(h[2p], h[2p+1])` as 32-bit lanes, `x` must have `R*N + 2*mp` readable samples.
+template <std::size_t R>
+__attribute__((always_inline))
+inline void correlate_q15_tile(const int16_t* x, const int32_t* hp, std::size_t mp, int16_t* y)
+{
+    using V = native<int16_t>;
+    using W = native<int32_t>;
+    constexpr std::size_t N = nrelem<V>();
+
+    // lane k of even[r] is output 2k of vector r, lane k of odd[r] is output 2k+1
+    W even[R] = {}, odd[R] = {};
+    for (std::size_t p = 0; p < mp; ++p) {
+        const V pair = (V)broadcast<W>(hp[p]);
+        vx::unroll<R>([&](std::size_t r) {
+            V x0, x1;
+            loadu(x0, x + r*N + 2*p);
+            loadu(x1, x + r*N + 2*p + 1);
+            even[r] += madd_pairs(x0, pair);
+            odd[r] += madd_pairs(x1, pair);
+        });
+    }
+
+    const W round = broadcast<W>(1 << 14), lo = broadcast<W>(INT16_MIN), hi = broadcast<W>(INT16_MAX);
+    vx::unroll<R>([&](std::size_t r) {
+        const W e = min(max((even[r] + round) >> 15, lo), hi);
+        const W o = min(max((odd[r] + round) >> 15, lo), hi);
+        // little endian: even output in the low half of the 32-bit lane
+        storeu(y + r*N, (V)((o << 16) | (e & 0xFFFF)));
+    });
+}
+
+/// Q15 valid cross-correlation, `y[i] = sat((∑ x[i+j]*h[j] + 2^14) >> 15)`.
+///
+/// Accumulators are 32-bit, the sum must not overflow: `∑|h[j]| < 65536`
+/// is enough for any input, i.e. gain below 2 in Q15.
+inline void correlate_direct(const int16_t* x, const int16_t* h, std::size_t m, int16_t* y, std::size_t ny)
+{
+    using V = native<int16_t>;
+    constexpr std::size_t N = nrelem<V>();
+    constexpr std::size_t R = 4;
+
+    const std::size_t mp = (m + 1) / 2;
+    std::vector<int32_t> hp(mp);
+    for (std::size_t p = 0; p < mp; ++p) {
+        const uint16_t h1 = (2*p + 1 < m) ? (uint16_t)h[2*p + 1] : 0;
+        hp[p] = (int32_t)((uint32_t)(uint16_t)h[2*p] | ((uint32_t)h1 << 16));
+    }
+
+    // loads reach x[i + R*N + 2*mp - 1], x has ny + m - 1 samples
+    std::size_t i = 0;
+    for (; i + R*N + 2*mp <= ny + m; i += R*N) {
+        correlate_q15_tile<R>(x + i, hp.data(), mp, y + i);
+    }
+    for (; i + N + 2*mp <= ny + m and i + N <= ny; i += N) {
+        correlate_q15_tile<1>(x + i, hp.data(), mp, y + i);
+    }
+    if (i < ny) {
+        // zero padded copy of the rest
+        const std::size_t rest = ny - i, tiles = (rest + N - 1) / N;
+        std::vector<int16_t> xb(tiles * N + 2*mp), yb(tiles * N);
+        std::copy(x + i, x + ny + m - 1, xb.begin());
+        for (std::size_t t = 0; t < tiles; ++t) {
+            correlate_q15_tile<1>(xb.data() + t*N, hp.data(), mp, yb.data() + t*N);
+        }
+        std::copy_n(yb.begin(), rest, y + i);
+    }
+}
+
+/// `re + i im *= hr + i hi` for `n` bins.
+template <typename T>
+void mul_spectrum(T* re, T* im, const T* hr, const T* hi, std::size_t n)
+{
+    using V = native<T>;
+    using M = typename get_mask<V>::type;
+    constexpr std::size_t N = nrelem<V>();
+
+    cx::Complex<V> a, b;
+    std::size_t k = 0;
+    for (; k + N <= n; k += N) {
+        loadu(a.real, re + k); loadu(a.img, im + k);
+        loadu(b.real, hr + k); loadu(b.img, hi + k);
+        const cx::Complex<V> c = cx::mul(a, b);
+        storeu(re + k, c.real); storeu(im + k, c.img);
+    }
+    if (k < n) {
+        const M mask = mask_first_n<M>(n - k);
+        a = cx::zero_vector<cx::Complex<V>>(); b = a;
+        maskload(a.real, re + k, mask); maskload(a.img, im + k, mask);
+        maskload(b.real, hr + k, mask); maskload(b.img, hi + k, mask);
+        const cx::Complex<V> c = cx::mul(a, b);
+        maskstore(re + k, c.real, mask); maskstore(im + k, c.img, mask);
+    }
+}
+
+/// Overlap-save correlation with fixed taps.
+///
+/// FFT size is a power of 2 at least `8*m`, every block of `nfft` samples
+/// gives `nfft - m + 1` outputs.
+template <typename T>
+class fft_correlator
+{
+    std::size_t m_;
+    std::size_t nfft_;
+    fft::real_plan<T> plan_;
+    std::vector<T> hr_, hi_; // spectrum of reversed taps, divided by nfft
+    std::vector<T> seg_, re_, im_;
+
+public:
+    fft_correlator(const T* h, std::size_t m) :
+        m_(m), nfft_(std::bit_ceil(std::max<std::size_t>(8*m, 256))), plan_(nfft_),
+        hr_(plan_.bins()), hi_(plan_.bins()), seg_(nfft_), re_(plan_.bins()), im_(plan_.bins())
+    {
+        // correlation is convolution with reversed taps
+        const T scale = T{1} / (T)nfft_;
+        for (std::size_t j = 0; j < m; ++j) seg_[j] = h[m - 1 - j] * scale;
+        plan_.forward(seg_, hr_, hi_);
+    }
+
+    /// Number of outputs per FFT block.
+    std::size_t step() const {return nfft_ - m_ + 1;}
+
+    /// `y[i] = ∑ x[i+j]*h[j]`, `x` holds `ny + m - 1` samples.
+    void run(const T* x, T* y, std::size_t ny)
+    {
+        for (std::size_t s = 0; s < ny; s += step()) {
+            const std::size_t cnt = std::min(step(), ny - s);
+            const std::size_t len = cnt + m_ - 1;
+            std::copy_n(x + s, len, seg_.begin());
+            std::fill(seg_.begin() + len, seg_.end(), T{});
+            plan_.forward(seg_, re_, im_);
+            mul_spectrum(re_.data(), im_.data(), hr_.data(), hi_.data(), re_.size());
+            plan_.inverse(re_, im_, seg_);
+            // circular wrap-around spoils the first m-1 samples
+            std::copy_n(seg_.begin() + (m_ - 1), cnt, y + s);
+        }
+    }
+};
+
+template <typename T>
+bool use_fft(std::size_t m, std::size_t ny)
+{
+    return std::is_floating_point_v<T> and m >= fir_fft_taps and ny >= m;
+}
+
+} // namespace detail
+
+/// Valid cross-correlation `y[i] = ∑ x[i+j]*h[j]`, `y.size() == x.size() - h.size() + 1`
+/// (`numpy.correlate` default mode).
+///
+/// Q15 samples are rounded and saturated, see `detail::correlate_direct`.
+///
+/// Example:
+/// ```c++
+/// std::vector<float> x(1000), h(32), y(x.size() - h.size() + 1);
+/// vx::correlate<float>(x, h, y);
+/// ```
+template <typename T>
+void correlate(std::span<const T> x, std::span<const T> h, std::span<T> y)
+{
+    assert(!h.empty() and x.size() >= h.size() and y.size() == x.size() - h.size() + 1);
+    if constexpr (std::is_floating_point_v<T>) {
+        if (detail::use_fft<T>(h.size(), y.size())) {
+            detail::fft_correlator<T>(h.data(), h.size()).run(x.data(), y.data(), y.size());
+            return;
+        }
+    }
+    detail::correlate_direct(x.data(), h.data(), h.size(), y.data(), y.size());
+}
+
+/// Full convolution `y[i] = ∑ x[i-j]*h[j]`, `y.size() == x.size() + h.size() - 1`
+/// (`numpy.convolve` default mode), samples outside of `x` are 0.
+template <typename T>
+void convolve(std::span<const T> x, std::span<const T> h, std::span<T> y)
+{
+    assert(!h.empty() and !x.empty() and y.size() == x.size() + h.size() - 1);
+    const std::size_t m = h.size();
+    std::vector<T> xp(x.size() + 2*(m - 1)), hr(h.rbegin(), h.rend());
+    std::copy(x.begin(), x.end(), xp.begin() + (m - 1));
+    correlate<T>(xp, hr, y);
+}
+
+/// Streaming FIR filter `y[n] = ∑ h[j]*x[n-j]`.
+///
+/// Keeps the last `taps - 1` input samples between `process` calls,
+/// so a stream split into blocks of any size gives the same output
+/// as one call on the whole stream. Filters with `fir_fft_taps` or more
+/// floating point taps match only up to rounding: overlap-save segments
+/// move with the blocks. Initial history is zero.
+///
+/// Example:
+/// ```c++
+/// vx::fir<float> lowpass(taps);
+/// for (auto& block : stream) lowpass.process(block, block); // in place
+/// ```
+template <typename T>
+class fir
+{
+    std::vector<T> h_;   // reversed taps
+    std::vector<T> buf_; // history followed by input block
+    std::size_t block_;
+    // FFT state only exists for floating point samples
+    std::conditional_t<std::is_floating_point_v<T>, std::optional<detail::fft_correlator<T>>, std::monostate> fft_;
+
+public:
+    explicit fir(std::span<const T> taps) : h_(taps.rbegin(), taps.rend()), block_(4096)
+    {
+        assert(!taps.empty());
+        if constexpr (std::is_floating_point_v<T>) {
+            if (taps.size() >= fir_fft_taps) {
+                fft_.emplace(h_.data(), h_.size());
+                block_ = fft_->step() * ((block_ + fft_->step() - 1) / fft_->step());
+            }
+        }
+        buf_.assign(taps.size() - 1 + block_, T{});
+    }
+
+    /// Number of taps.
+    std::size_t taps() const {return h_.size();}
+
+    /// Clears input history.
+    void reset() {std::fill(buf_.begin(), buf_.end(), T{});}
+
+    /// Filters `in` into `out` of the same size, `in` and `out` may be the same array.
+    void process(std::span<const T> in, std::span<T> out)
+    {
+        assert(in.size() == out.size());
+        const std::size_t hist = h_.size() - 1;
+        for (std::size_t s = 0; s < in.size(); s += block_) {
+            const std::size_t n = std::min(block_, in.size() - s);
+            std::copy_n(in.begin() + s, n, buf_.begin() + hist);
+            bool done = false;
+            if constexpr (std::is_floating_point_v<T>) {
+                if (fft_) {
+                    fft_->run(buf_.data(), out.data() + s, n);
+                    done = true;
+                }
+            }
+            if (!done) detail::correlate_direct(buf_.data(), h_.data(), h_.size(), out.data() + s, n);
+            std::copy_n(buf_.begin() + n, hist, buf_.begin());
+        }
+    }
+};
+
+} // namespace vx
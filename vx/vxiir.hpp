@@ -0,0 +1,218 @@
+/**@file
+ * @brief     Multichannel biquad IIR filter cascade.
+ * @author    Igor Lesik 2021
+ * @copyright Igor Lesik 2021
+ *
+ * IIR recursion is serial in time, so the vectorized dimension is channels:
+ * every lane of `V` is one channel (structure of arrays). Channels are
+ * processed in groups of `nrelem<V>()`, filter state of a group stays in
+ * registers for the whole block and is written back at the end.
+ *
+ * Interleaved frames (`x[f*channels + c]`) load one frame of a group with
+ * a single vector load. Planar input (`x[c*frames + f]`) is transposed in
+ * `N×N` register tiles on the fly.
+ *
+ * Sections are Direct Form II transposed with coefficients normalized by `a0`:
+ * ```
+ * y  = b0*x + s1
+ * s1 = b1*x - a1*y + s2
+ * s2 = b2*x - a2*y
+ * ```
+ */
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "vx/vxtypes.hpp"
+#include "vx/vxops.hpp"
+#include "vx/vxfun.hpp"
+
+namespace vx {
+
+/// Coefficients of one biquad section, normalized by `a0`.
+template <typename T>
+struct biquad
+{
+    T b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+};
+
+/// Cascade of `S` biquad sections for any number of channels, one channel per lane of `V`.
+///
+/// Coefficients are per section and per channel and can be changed between
+/// `process` calls, filter state is kept. Default sections pass input through.
+///
+/// Example:
+/// ```c++
+/// vx::biquad_cascade<F32x16, 2> eq(24);         // 24 channels, 2 sections
+/// eq.set(0, vx::biquad<float>{b0, b1, b2, a1, a2}); // section 0 of all channels
+/// eq.process(frames, frames);                   // interleaved, in place
+/// ```
+template <typename V, std::size_t S>
+class biquad_cascade
+{
+    using T = typename get_base<V>::type;
+    using M = typename get_mask<V>::type;
+    static constexpr std::size_t N = nrelem<V>();
+
+    struct section
+    {
+        V b0, b1, b2, a1, a2;
+    };
+
+    std::size_t channels_;
+    std::size_t groups_;
+    std::vector<section> coef_; // [group][section]
+    std::vector<V> state_;      // [group][section][s1, s2]
+
+    /// One frame `x` of a group through all sections.
+    __attribute__((always_inline))
+    static inline V step(const section (&c)[S], V (&s1)[S], V (&s2)[S], V x)
+    {
+        vx::unroll<S>([&](std::size_t k) {
+            const V y = madd(c[k].b0, x, s1[k]);
+            s1[k] = nmadd(c[k].a1, y, madd(c[k].b1, x, s2[k]));
+            s2[k] = nmadd(c[k].a2, y, c[k].b2 * x);
+            x = y;
+        });
+        return x;
+    }
+
+    /// Runs `f(c, s1, s2)` with coefficients and state of group `g` in local arrays.
+    template <typename F>
+    __attribute__((always_inline))
+    inline void with_group(std::size_t g, F f)
+    {
+        section c[S];
+        V s1[S], s2[S];
+        vx::unroll<S>([&](std::size_t k) {
+            c[k] = coef_[g*S + k];
+            s1[k] = state_[2*(g*S + k)];
+            s2[k] = state_[2*(g*S + k) + 1];
+        });
+        f(c, s1, s2);
+        vx::unroll<S>([&](std::size_t k) {
+            state_[2*(g*S + k)] = s1[k];
+            state_[2*(g*S + k) + 1] = s2[k];
+        });
+    }
+
+public:
+    explicit biquad_cascade(std::size_t channels) :
+        channels_(channels), groups_((channels + N - 1) / N), coef_(groups_ * S), state_(2 * groups_ * S)
+    {
+        assert(channels > 0);
+        set(biquad<T>{});
+        reset();
+    }
+
+    /// Number of channels.
+    std::size_t channels() const {return channels_;}
+
+    /// Sets coefficients of `section` for one `channel`.
+    void set(std::size_t sec, std::size_t channel, const biquad<T>& b)
+    {
+        assert(sec < S and channel < channels_);
+        section& c = coef_[channel / N * S + sec];
+        const std::size_t lane = channel % N;
+        c.b0[lane] = b.b0; c.b1[lane] = b.b1; c.b2[lane] = b.b2;
+        c.a1[lane] = b.a1; c.a2[lane] = b.a2;
+    }
+
+    /// Sets coefficients of `section` for all channels.
+    void set(std::size_t sec, const biquad<T>& b)
+    {
+        assert(sec < S);
+        for (std::size_t g = 0; g < groups_; ++g) {
+            coef_[g*S + sec] = section{broadcast<V>(b.b0), broadcast<V>(b.b1), broadcast<V>(b.b2),
+                                       broadcast<V>(b.a1), broadcast<V>(b.a2)};
+        }
+    }
+
+    /// Sets coefficients of all sections for all channels.
+    void set(const biquad<T>& b)
+    {
+        for (std::size_t k = 0; k < S; ++k) set(k, b);
+    }
+
+    /// Clears filter state.
+    void reset()
+    {
+        std::fill(state_.begin(), state_.end(), V{});
+    }
+
+    /// Filters interleaved frames, `in[f*channels() + c]`, `in` and `out` may be the same array.
+    void process(std::span<const T> in, std::span<T> out)
+    {
+        assert(in.size() == out.size() and in.size() % channels_ == 0);
+        const std::size_t C = channels_, frames = in.size() / C;
+        for (std::size_t g = 0; g < groups_; ++g) {
+            const T* x = in.data() + g*N;
+            T* y = out.data() + g*N;
+            const std::size_t lanes = std::min(N, C - g*N);
+            with_group(g, [&](const section (&c)[S], V (&s1)[S], V (&s2)[S]) {
+                if (lanes == N) {
+                    for (std::size_t f = 0; f < frames; ++f) {
+                        V v;
+                        loadu(v, x + f*C);
+                        storeu(y + f*C, step(c, s1, s2, v));
+                    }
+                }
+                else {
+                    const M m = mask_first_n<M>(lanes);
+                    for (std::size_t f = 0; f < frames; ++f) {
+                        V v{};
+                        maskload(v, x + f*C, m);
+                        maskstore(y + f*C, step(c, s1, s2, v), m);
+                    }
+                }
+            });
+        }
+    }
+
+    /// Filters planar channels, `in[c*frames + f]`, `in` and `out` may be the same array.
+    ///
+    /// Tiles of `N` channels × `N` frames are transposed to frames of channels
+    /// in registers before filtering and back after.
+    void process_planar(std::span<const T> in, std::span<T> out)
+    {
+        assert(in.size() == out.size() and in.size() % channels_ == 0);
+        const std::size_t frames = in.size() / channels_;
+        for (std::size_t g = 0; g < groups_; ++g) {
+            const std::size_t lanes = std::min(N, channels_ - g*N);
+            const T* x = in.data() + g*N*frames;
+            T* y = out.data() + g*N*frames;
+            with_group(g, [&](const section (&c)[S], V (&s1)[S], V (&s2)[S]) {
+                V r[N];
+                std::size_t f = 0;
+                for (; f + N <= frames; f += N) {
+                    for (std::size_t l = 0; l < N; ++l) {
+                        if (l < lanes) loadu(r[l], x + l*frames + f);
+                        else r[l] = V{};
+                    }
+                    transpose(r);
+                    for (std::size_t t = 0; t < N; ++t) r[t] = step(c, s1, s2, r[t]);
+                    transpose(r);
+                    for (std::size_t l = 0; l < lanes; ++l) storeu(y + l*frames + f, r[l]);
+                }
+                if (f < frames) {
+                    const std::size_t rest = frames - f;
+                    const M m = mask_first_n<M>(rest);
+                    for (std::size_t l = 0; l < N; ++l) {
+                        r[l] = V{};
+                        if (l < lanes) maskload(r[l], x + l*frames + f, m);
+                    }
+                    transpose(r);
+                    for (std::size_t t = 0; t < rest; ++t) r[t] = step(c, s1, s2, r[t]);
+                    transpose(r);
+                    for (std::size_t l = 0; l < lanes; ++l) maskstore(y + l*frames + f, r[l], m);
+                }
+            });
+        }
+    }
+};
+
+} // namespace vx
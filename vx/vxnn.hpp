@@ -0,0 +1,78 @@
+/**@file
+ * @brief     Neural network activation functions.
+ * @author    Igor Lesik 2021
+ * @copyright Igor Lesik 2021
+ *
+ * Activations work in place on `std::span` of F32/F64 elements
+ * and elementwise on `vx::array`. Vector math is from `vx/vxmath.hpp`,
+ * `accuracy::fast` tier trades a few ulp for speed, see error bounds there.
+ *
+ * Span loops use the widest enabled vector `vx::native<T>`:
+ * masked head until data is aligned, aligned main loop and masked tail.
+ */
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include "vx/vxtypes.hpp"
+#include "vx/vxops.hpp"
+#include "vx/vxarray.hpp"
+#include "vx/vxblas.hpp"
+#include "vx/vxmath.hpp"
+
+namespace vx::nn {
+
+/// Applies vector function `f` to every element of `x` in place.
+template <typename T, typename F>
+void apply(std::span<T> x, F f)
+{
+    using V = native<T>;
+    using M = typename get_mask<V>::type;
+    constexpr std::size_t N = nrelem<V>();
+    T* p = x.data();
+    const std::size_t n = x.size();
+
+    V v;
+    std::size_t i = blas::aligned_head<V>(p, n);
+    if (i) {
+        const M m = mask_first_n<M>(i);
+        maskload(v, p, m);
+        maskstore(p, f(v), m);
+    }
+    for (; i + N <= n; i += N) {
+        load(v, p + i);
+        store(p + i, f(v));
+    }
+    if (i < n) {
+        const M m = mask_first_n<M>(n - i);
+        maskload(v, p + i, m);
+        maskstore(p + i, f(v), m);
+    }
+}
+
+#define VX_NN_ACTIVATION(name, fun) \
+template <typename T, accuracy A = accuracy::accurate> \
+void name(std::span<T> x) {apply<T>(x, [](auto v) {return fun<A>(v);});} \
+\
+template <typename T, accuracy A = accuracy::accurate, std::size_t Sz> \
+array<T,Sz> name(const array<T,Sz>& x) {array<T,Sz> y(x); name<T, A>(std::span<T>(y.elements())); return y;}
+
+/// `tanh(x)`.
+VX_NN_ACTIVATION(tanh, vx::tanh)
+/// Logistic function `1 / (1 + e^-x)`.
+VX_NN_ACTIVATION(sigmoid, vx::sigmoid)
+/// GELU `x * Phi(x)`, exact form with `erf`.
+VX_NN_ACTIVATION(gelu, vx::gelu)
+/// GELU, tanh approximation.
+VX_NN_ACTIVATION(gelu_tanh, vx::gelu_tanh)
+/// Error function.
+VX_NN_ACTIVATION(erf, vx::erf)
+/// Softplus `ln(1 + e^x)`.
+VX_NN_ACTIVATION(softplus, vx::softplus)
+/// SiLU (swish) `x * sigmoid(x)`.
+VX_NN_ACTIVATION(silu, vx::silu)
+
+#undef VX_NN_ACTIVATION
+
+} // namespace vx::nn
@@ -0,0 +1,251 @@
+/**@file
+ * @brief     Bilinear and bicubic resize of U8 and F32 images.
+ * @author    Igor Lesik 2021
+ * @copyright Igor Lesik 2021
+ *
+ * Images have `channels` interleaved elements per pixel: 1 for planar
+ * images, 4 for RGBA. Pixel centers are aligned, source coordinate of
+ * destination pixel `d` is `(d + 0.5)*src/dst - 0.5`, pixels outside the
+ * image replicate the edge. Bicubic is Keys cubic with `a = -0.5`.
+ * Filters have 2 or 4 taps at any scale, so shrinking by more than 2
+ * skips pixels; blur first (`vx/vxblur.hpp`) to avoid aliasing.
+ *
+ * Every destination row is a vertical pass over source rows into a row
+ * of source width, then a horizontal pass of that row. Vertical pass is
+ * vectorized across elements, horizontal pass gathers (`vx::gather`)
+ * source elements of the taps of every destination element. Taps and
+ * weights of both axes are computed once per call; taps at the edges are
+ * folded into the image so no tap reads outside it.
+ *
+ * U8 images use fixed point: Q14 weights, vertical sums are kept with 7
+ * fraction bits in 32-bit lanes, horizontal sums are rounded and
+ * saturated once. Rows are independent, so destination is split into
+ * strips of rows that run on `threads` threads.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "vx/vxtypes.hpp"
+#include "vx/vxops.hpp"
+#include "vx/vxfun.hpp"
+
+namespace vx::image {
+
+/// Interpolation filter of `resize`.
+enum class resize_filter {bilinear, bicubic};
+
+namespace detail::resize {
+
+using F = native<float>;
+constexpr std::size_t N = nrelem<F>();
+using I = typename get_mask<F>::type;
+
+/// Fraction bits of U8 weights and of vertical sums.
+constexpr unsigned wbits = 14, vbits = 7;
+
+/// Keys cubic with `a = -0.5`.
+inline float cubic(float x)
+{
+    x = std::abs(x);
+    if (x < 1) return (1.5f*x - 2.5f)*x*x + 1;
+    if (x < 2) return ((-0.5f*x + 2.5f)*x - 4)*x + 2;
+    return 0;
+}
+
+/// Taps of `dst` coordinates into `src` coordinates: first tap and `taps` weights of each.
+struct table
+{
+    std::size_t taps;
+    std::vector<int32_t> start;
+    std::vector<float> weight;    ///< `taps` per coordinate
+    std::vector<int32_t> fixed;   ///< weights in Q14, sum to exactly 1
+
+    table(std::size_t src, std::size_t dst, resize_filter f)
+    {
+        assert(src > 0 and dst > 0);
+        const std::ptrdiff_t n = src, t = f == resize_filter::bicubic ? 4 : 2;
+        taps = std::min(t, n);
+        start.resize(dst);
+        weight.assign(dst * taps, 0.0f);
+        fixed.resize(dst * taps);
+        const double scale = (double)src / dst;
+        for (std::size_t d = 0; d < dst; ++d) {
+            const double s = (d + 0.5) * scale - 0.5;
+            const std::ptrdiff_t i0 = std::floor(s) - (t/2 - 1);
+            const float frac = s - std::floor(s);
+            // window of `taps` inside the image, outside taps folded to the edge pixel
+            const std::ptrdiff_t first = std::clamp(i0, (std::ptrdiff_t)0, n - (std::ptrdiff_t)taps);
+            start[d] = first;
+            float* w = &weight[d * taps];
+            for (std::ptrdiff_t k = 0; k < t; ++k) {
+                const float x = frac - (k - (t/2 - 1));
+                const float v = t == 2 ? 1 - std::abs(x) : cubic(x);
+                w[std::clamp(i0 + k, (std::ptrdiff_t)0, n - 1) - first] += v;
+            }
+            // rounded fixed point, rounding error goes to the largest weight
+            int32_t* q = &fixed[d * taps];
+            int32_t sum = 0;
+            for (std::size_t k = 0; k < taps; ++k) sum += q[k] = std::lround(w[k] * (1 << wbits));
+            q[std::max_element(w, w + taps) - w] += (1 << wbits) - sum;
+        }
+    }
+};
+
+/// Horizontal taps per destination element: source element index and weights of tap `k` at `k*n`.
+template <typename W>
+struct element_table
+{
+    std::vector<int32_t> index;
+    std::vector<W> weight;
+
+    element_table(const table& t, std::size_t channels)
+    {
+        const std::size_t n = t.start.size() * channels;
+        index.resize(n);
+        weight.resize(n * t.taps);
+        for (std::size_t j = 0; j < n; ++j) {
+            const std::size_t d = j / channels;
+            index[j] = t.start[d] * channels + j % channels;
+            for (std::size_t k = 0; k < t.taps; ++k) {
+                if constexpr (std::is_same_v<W, float>) weight[k*n + j] = t.weight[d*t.taps + k];
+                else weight[k*n + j] = t.fixed[d*t.taps + k];
+            }
+        }
+    }
+};
+
+/// Destination rows `[y0, y1)`, `row` is a buffer of source width.
+template <typename T, typename W>
+void resize_rows(const T* src, std::size_t src_stride, std::size_t src_elems,
+    T* dst, std::size_t dst_stride, std::size_t channels,
+    const table& ty, const element_table<W>& hx, std::size_t htaps,
+    std::size_t y0, std::size_t y1, W* row)
+{
+    using V = std::conditional_t<std::is_same_v<T, float>, F, I>;
+    constexpr bool fp = std::is_same_v<T, float>;
+    const std::size_t n = hx.index.size();
+    const std::vector<int32_t>& yw = ty.fixed;
+    const std::size_t vt = ty.taps;
+
+    for (std::size_t y = y0; y < y1; ++y) {
+        const T* rows = src + ty.start[y] * src_stride;
+
+        // vertical pass, row[i] = sum of weighted source rows
+        std::size_t i = 0;
+        for (; i + N <= src_elems; i += N) {
+            V acc{};
+            for (std::size_t k = 0; k < vt; ++k) {
+                V v;
+                if constexpr (fp) loadu(v, rows + k*src_stride + i);
+                else loadu_widen(v, rows + k*src_stride + i);
+                if constexpr (fp) acc = madd(v, broadcast<F>(ty.weight[y*vt + k]), acc);
+                else acc += v * yw[y*vt + k];
+            }
+            if constexpr (fp) storeu(row + i, acc);
+            else storeu(row + i, (acc + (1 << (wbits - vbits - 1))) >> (wbits - vbits));
+        }
+        for (; i < src_elems; ++i) {
+            if constexpr (fp) {
+                float acc = 0;
+                for (std::size_t k = 0; k < vt; ++k) acc = std::fma(rows[k*src_stride + i], ty.weight[y*vt + k], acc);
+                row[i] = acc;
+            }
+            else {
+                int32_t acc = 0;
+                for (std::size_t k = 0; k < vt; ++k) acc += rows[k*src_stride + i] * yw[y*vt + k];
+                row[i] = (acc + (1 << (wbits - vbits - 1))) >> (wbits - vbits);
+            }
+        }
+
+        // horizontal pass, gathers of tap k at index + k*channels
+        T* out = dst + y*dst_stride;
+        constexpr int32_t half = 1 << (wbits + vbits - 1);
+        std::size_t j = 0;
+        for (; j + N <= n; j += N) {
+            I idx;
+            loadu(idx, hx.index.data() + j);
+            V acc{};
+            for (std::size_t k = 0; k < htaps; ++k) {
+                V v, w;
+                gather(v, row, idx + (int32_t)(k*channels));
+                loadu(w, hx.weight.data() + k*n + j);
+                if constexpr (fp) acc = madd(v, w, acc);
+                else acc += v * w;
+            }
+            if constexpr (fp) {
+                storeu(out + j, acc);
+            }
+            else {
+                const I r = min(max((acc + half) >> (wbits + vbits), I{}), broadcast<I>(255));
+                const auto b = __builtin_convertvector(r, typename make<uint8_t, N>::type);
+                std::memcpy(out + j, &b, sizeof(b));
+            }
+        }
+        for (; j < n; ++j) {
+            const W* r = row + hx.index[j];
+            if constexpr (fp) {
+                float acc = 0;
+                for (std::size_t k = 0; k < htaps; ++k) acc = std::fma(r[k*channels], hx.weight[k*n + j], acc);
+                out[j] = acc;
+            }
+            else {
+                int32_t acc = 0;
+                for (std::size_t k = 0; k < htaps; ++k) acc += r[k*channels] * hx.weight[k*n + j];
+                out[j] = std::clamp((acc + half) >> (wbits + vbits), 0, 255);
+            }
+        }
+    }
+}
+
+} // namespace detail::resize
+
+/// Resizes image of `channels` interleaved `uint8_t` or `float` elements per pixel,
+/// strides are in elements. Destination rows are split into `threads` strips.
+///
+/// Example:
+/// ```c++
+/// using vx::image::resize_filter;
+/// vx::image::resize<uint8_t>(rgba, 4*w, w, h, out, 4*ow, ow, oh, 4, resize_filter::bicubic);
+/// ```
+template <typename T>
+void resize(const T* src, std::size_t src_stride, std::size_t src_width, std::size_t src_height,
+    T* dst, std::size_t dst_stride, std::size_t dst_width, std::size_t dst_height,
+    std::size_t channels = 1, resize_filter f = resize_filter::bilinear, unsigned threads = 1)
+{
+    using namespace detail::resize;
+    static_assert(std::is_same_v<T, uint8_t> or std::is_same_v<T, float>);
+    using W = std::conditional_t<std::is_same_v<T, float>, float, int32_t>;
+    assert(channels > 0 and threads > 0);
+    if (dst_width == 0 or dst_height == 0) return;
+
+    const table tx(src_width, dst_width, f), ty(src_height, dst_height, f);
+    const element_table<W> hx(tx, channels);
+    const std::size_t elems = src_width * channels;
+
+    const auto strip = [&](std::size_t y0, std::size_t y1) {
+        std::vector<W> row(elems);
+        resize_rows<T, W>(src, src_stride, elems, dst, dst_stride, channels, ty, hx, tx.taps, y0, y1, row.data());
+    };
+    threads = std::min<std::size_t>(threads, dst_height);
+    if (threads == 1) {
+        strip(0, dst_height);
+        return;
+    }
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(strip, dst_height * t / threads, dst_height * (t + 1) / threads);
+    }
+    strip(0, dst_height / threads);
+    for (auto& th : pool) th.join();
+}
+
+} // namespace vx::image
@@ -6,49 +6,319 @@
  */
 #pragma once
 
+#include <type_traits>
+#include <utility>
+
 namespace vx {
 
+/// Reduce all elements to one with associative operation `op`.
+///
+/// Log-depth shuffle tree: vectors wider than 128 bits are folded
+/// in halves (`vextract` + op), then 128-bit vector is folded
+/// with in-register shuffles, so `N` elements take `log2(N)` steps.
+///
+/// Example:
+/// ```c++
+/// int32_t m = reduce((I32x8){3,1,4,1,5,9,2,6}, [](auto a, auto b){return vx::max(a, b);});
+/// ```
+template <typename V, typename Op>
+typename get_base<V>::type reduce(const V v, Op op)
+{
+    constexpr unsigned n = nrelem<V>();
+
+    if constexpr (n == 1) {
+        return v[0];
+    }
+    else if constexpr (sizeof(V) > 16) {
+        return reduce(op(lo_half(v), hi_half(v)), op);
+    }
+    else {
+        using M = typename get_mask<V>::type;
+        V r = v;
+        for (unsigned k = n/2; k > 0; k /= 2) {
+            M rot;
+            for (unsigned i = 0; i < n; ++i) { rot[i] = (i + k) % n; } // folded at compile time
+            r = op(r, __builtin_shuffle(r, rot));
+        }
+        return r[0];
+    }
+}
+
+/// One round of `transpose`: swaps bit `H` of row index with bit `H` of column index.
+template <unsigned H, typename V>
+inline void transpose_round(V (&r)[nrelem<V>()])
+{
+    using M = typename get_mask<V>::type;
+    constexpr unsigned n = nrelem<V>();
+    constexpr auto mask = []<std::size_t... J>(bool high, std::index_sequence<J...>) {
+        using I = typename get_base<M>::type;
+        return M{(I)(high ? ((J & H) ? n + J : (J ^ H)) : ((J & H) ? n + (J ^ H) : J))...};
+    };
+    constexpr M lo = mask(false, std::make_index_sequence<n>{});
+    constexpr M hi = mask(true, std::make_index_sequence<n>{});
+
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        auto pair = [&](unsigned i) {
+            if (i & H) return;
+            const V a = r[i], b = r[i | H];
+            r[i] = __builtin_shuffle(a, b, lo);
+            r[i | H] = __builtin_shuffle(a, b, hi);
+        };
+        (pair(I), ...);
+    }(std::make_index_sequence<n>{});
+
+    if constexpr (H > 1) { transpose_round<H/2>(r); }
+}
+
+/// Transposes square matrix of `N = nrelem<V>()` rows in place, `r[i][j] <-> r[j][i]`.
+///
+/// `log2(N)` rounds of two-source shuffles (`unpck`/`vpermt2`),
+/// round `h` swaps bit `h` of row index with bit `h` of column index.
+///
+/// Example:
+/// ```c++
+/// F32x4 m[4] = {{0,1,2,3}, {4,5,6,7}, {8,9,10,11}, {12,13,14,15}};
+/// vx::transpose(m); // m[1] == {1,5,9,13}
+/// ```
+template <typename V>
+void transpose(V (&r)[nrelem<V>()])
+{
+    transpose_round<nrelem<V>()/2>(r);
+}
+
+/// Returns minimum of all elements.
+template <typename V>
+typename get_base<V>::type reduce_min(const V v)
+{
+#ifdef __SSE4_1__
+    if constexpr (is_vec<V,16,uint16_t>) {
+        return (uint16_t)_mm_cvtsi128_si32(_mm_minpos_epu16((__m128i)v)); // phminposuw
+    }
+    else
+#endif
+    return reduce(v, [](auto a, auto b) {return vx::min(a, b);});
+}
+
+/// Returns maximum of all elements.
+template <typename V>
+typename get_base<V>::type reduce_max(const V v)
+{
+#ifdef __SSE4_1__
+    if constexpr (is_vec<V,16,uint16_t>) {
+        return (uint16_t)~_mm_cvtsi128_si32(_mm_minpos_epu16((__m128i)~v)); // max(v) == ~min(~v)
+    }
+    else
+#endif
+    return reduce(v, [](auto a, auto b) {return vx::max(a, b);});
+}
+
+/// Returns bitwise AND of all elements.
+template <typename V>
+typename get_base<V>::type reduce_and(const V v)
+{
+    return reduce(v, [](auto a, auto b) {return a & b;});
+}
+
+/// Returns bitwise OR of all elements.
+template <typename V>
+typename get_base<V>::type reduce_or(const V v)
+{
+    return reduce(v, [](auto a, auto b) {return a | b;});
+}
+
+/// Returns bitwise XOR of all elements.
+template <typename V>
+typename get_base<V>::type reduce_xor(const V v)
+{
+    return reduce(v, [](auto a, auto b) {return a ^ b;});
+}
 
 /// Returns sum of all elements.
 ///
+/// When `Acc` is wider than elements the elements are widened before
+/// they are added, so the sum does not overflow:
+/// - 8-bit elements use `psadbw` against zero, it adds 8 bytes into 64-bit element;
+/// - 16-bit elements use `pmaddwd` with 1, it adds pairs into 32-bit elements;
+/// - other elements are converted half by half.
+///
 /// Example:
 /// ```c++
 /// V4ui a = {1,2,3,4};
 /// assert(sum<uint32_t>(a) == (1+2+3+4));
+/// U8x16 b = (U8x16){} + 255;
+/// assert(sum<uint32_t>(b) == 255*16);
 /// ```
 template <typename Acc, typename T> Acc sum(T v)
 {
-    if constexpr(nrelem<T>() == 8) {
-        return (Acc)v[0] + v[1] + v[2] + v[3] + v[4] + v[5] + v[6] + v[7];
+    using E = typename get_base<T>::type;
+    constexpr unsigned n = nrelem<T>();
+    constexpr bool widen = sizeof(Acc) > sizeof(E);
+
+    if constexpr (widen and std::is_integral_v<E> and sizeof(E) == 1 and sizeof(T) >= 16) {
+        T u = v;
+        if constexpr (std::is_signed_v<E>) { u ^= (E)0x80; } // -128..127 -> 0..255
+        U64x2 s;
+        if constexpr (sizeof(T) == 16) { s = (U64x2)_mm_sad_epu8((__m128i)u, _mm_setzero_si128()); }
+#ifdef __AVX2__
+        else if constexpr (sizeof(T) == 32) {
+            U64x4 s4 = (U64x4)_mm256_sad_epu8((__m256i)u, _mm256_setzero_si256());
+            s = lo_half(s4) + hi_half(s4); }
+#endif
+#ifdef __AVX512BW__
+        else if constexpr (sizeof(T) == 64) {
+            U64x8 s8 = (U64x8)_mm512_sad_epu8((__m512i)u, _mm512_setzero_si512());
+            U64x4 s4 = lo_half(s8) + hi_half(s8);
+            s = lo_half(s4) + hi_half(s4); }
+#endif
+        else {
+            // halves are already biased, add them as unsigned bytes
+            using B = typename make<uint8_t, n/2>::type;
+            s = (U64x2){sum<uint64_t>((B)lo_half(u)), sum<uint64_t>((B)hi_half(u))}; }
+        Acc r = (Acc)(s[0] + s[1]);
+        if constexpr (std::is_signed_v<E>) { r -= (Acc)(128 * n); }
+        return r;
+    }
+    else if constexpr (widen and std::is_integral_v<E> and sizeof(E) == 2 and sizeof(T) >= 16) {
+        T u = v;
+        if constexpr (std::is_unsigned_v<E>) { u ^= (E)0x8000; } // 0..65535 -> -32768..32767
+        using P = typename make<int32_t, n/2>::type;
+        P s;
+        if constexpr (sizeof(T) == 16) { s = (P)_mm_madd_epi16((__m128i)u, _mm_set1_epi16(1)); }
+#ifdef __AVX2__
+        else if constexpr (sizeof(T) == 32) { s = (P)_mm256_madd_epi16((__m256i)u, _mm256_set1_epi16(1)); }
+#endif
+#ifdef __AVX512BW__
+        else if constexpr (sizeof(T) == 64) { s = (P)_mm512_madd_epi16((__m512i)u, _mm512_set1_epi16(1)); }
+#endif
+        else {
+            // biased lanes as signed, like pmaddwd reads them
+            for (unsigned i = 0; i < n/2; ++i) { s[i] = (int32_t)(int16_t)u[2*i] + (int16_t)u[2*i+1]; } }
+        Acc r = (Acc)reduce(s, [](auto a, auto b) {return a + b;}); // at most 32*65535, fits
+        if constexpr (std::is_unsigned_v<E>) { r += (Acc)(32768 * n); }
+        return r;
+    }
+    else if constexpr (widen and n > 2 and sizeof(Acc) <= 8) {
+        // convert halves to wider elements, add, and continue with half the elements
+        using W = std::conditional_t<std::is_floating_point_v<Acc>, Acc,
+                  std::conditional_t<std::is_signed_v<E>,
+                      std::conditional_t<sizeof(Acc) == 8, int64_t, int32_t>,
+                      std::conditional_t<sizeof(Acc) == 8, uint64_t, uint32_t>>>;
+        using H = typename make<W, n/2>::type;
+        H h = __builtin_convertvector(lo_half(v), H) + __builtin_convertvector(hi_half(v), H);
+        return sum<Acc>(h);
     }
-    else if constexpr(nrelem<T>() == 4) {
-        return (Acc)v[0] + v[1] + v[2] + v[3];
+    else if constexpr (widen) {
+        Acc r = 0;
+        for (unsigned i = 0; i < n; ++i) { r += v[i]; }
+        return r;
     }
-    else if constexpr(nrelem<T>() == 2) {
-        return (Acc)v[0] + v[1];
+    else {
+        return (Acc)reduce(v, [](auto a, auto b) {return a + b;});
     }
 }
 
-#ifdef __AVX__
-// https://stackoverflow.com/questions/49941645/get-sum-of-values-stored-in-m256d-with-sse-avx
-//
-template <> double sum<double,F64x4>(F64x4 v)
+/// Summation algorithm of long floating point reductions.
+///
+/// - `plain` adds values as they come;
+/// - `kahan` carries per-lane error term of additions (Kahan);
+/// - `neumaier` carries exact error of each addition (Knuth's TwoSum),
+///   unlike Kahan it stays accurate when added value is bigger than the sum.
+enum class summation {plain, kahan, neumaier};
+
+/// Vector accumulator with per-lane error term for compensated summation.
+///
+/// Sum and error stay in vector registers while adding,
+/// lanes are combined only in `result()`.
+///
+/// Example:
+/// ```c++
+/// vx::accumulator<vx::summation::neumaier, F64x4> acc;
+/// acc.add((F64x4){0x1p60, 1, -0x1p60, 1}); // 2^60 + 1 is not representable
+/// acc.add((F64x4){1, 1, 1, 1});
+/// assert(acc.result() == 6);
+/// ```
+template <summation S, typename V>
+struct accumulator
 {
-    __m128d vlow  = _mm256_castpd256_pd128(v);
-    __m128d vhigh = _mm256_extractf128_pd(v, 1); // high 128
-            vlow  = _mm_add_pd(vlow, vhigh);     // reduce down to 128
+    using T = typename get_base<V>::type;
+    static_assert(S == summation::plain or std::is_floating_point_v<T>,
+        "compensated summation needs floating point elements");
 
-    __m128d high64 = _mm_unpackhi_pd(vlow, vlow);
-    return  _mm_cvtsd_f64(_mm_add_sd(vlow, high64));  // reduce to scalar
-}
+    V sum{};
+    V err{}; ///< per-lane correction, exact sum is `sum + err`
+
+    void add(const V x) {
+        if constexpr (S == summation::plain) {
+            sum += x;
+        }
+        else if constexpr (S == summation::kahan) {
+            const V y = x + err;
+            const V t = sum + y;
+            err = y - (t - sum);
+            sum = t;
+        }
+        else {
+            const V t = sum + x;
+            const V z = t - sum;
+            err += (sum - (t - z)) + (x - z);
+            sum = t;
+        }
+    }
+
+    /// Adds products `a*b`; with FMA rounding errors of products are compensated too.
+    void add_product(const V a, const V b) {
+        if constexpr (S == summation::plain) {
+            sum = madd(a, b, sum);
+        }
+        else {
+            const V p = a * b;
+#ifdef __FMA__
+            err += msub(a, b, p); // exact a*b - p
 #endif
+            add(p);
+        }
+    }
+
+    /// Adds other accumulator, used to combine unrolled accumulators.
+    void merge(const accumulator& other) {
+        add(other.sum);
+        if constexpr (S != summation::plain) { err += other.err; }
+    }
 
-//inner product v = sum (mul(v1,v2))
-template <typename Acc, typename V>
+    /// Returns sum of all lanes.
+    T result() const {
+        if constexpr (S == summation::plain) {
+            return vx::sum<T>(sum);
+        }
+        else {
+            T s = 0, c = 0;
+            for (unsigned i = 0; i < nrelem<V>(); ++i) {
+                const T t = s + sum[i];
+                const T z = t - s;
+                c += (s - (t - z)) + (sum[i] - z) + err[i];
+                s = t;
+            }
+            return s + c;
+        }
+    }
+};
+
+/// Inner product `sum(mul(v1, v2))`.
+///
+/// With compensated summation `S` the result is as if computed
+/// in twice the working precision.
+template <typename Acc, summation S = summation::plain, typename V>
 Acc dot(const V& v1, const V& v2)
 {
-    V v = vx::mul(v1, v2);
-    return sum<Acc,V>(v);
+    if constexpr (S == summation::plain) {
+        V v = vx::mul(v1, v2);
+        return sum<Acc,V>(v);
+    }
+    else {
+        accumulator<S, V> acc;
+        acc.add_product(v1, v2);
+        return (Acc)acc.result();
+    }
 }
 
 /// Change sign: a -> -a
@@ -61,5 +331,49 @@ V inverse(const V& v)
     return vx::sub(zero, v); // 0 - a == -a
 }
 
+/// `f(0), ..., f(R-1)` unrolled, so small fixed-size arrays of vectors stay in registers.
+template <std::size_t R, typename F>
+__attribute__((always_inline)) inline void unroll(F f)
+{
+    [&]<std::size_t... K>(std::index_sequence<K...>) {
+        (f(K), ...);
+    }(std::make_index_sequence<R>{});
+}
+
+/// Shuffle mask with element `j` set to `f(j)`, `f` must be constexpr.
+template <typename V, typename F>
+constexpr typename get_mask<V>::type lane_mask(F f)
+{
+    using M = typename get_mask<V>::type;
+    using MT = typename get_base<M>::type;
+    return [&]<std::size_t... J>(std::index_sequence<J...>) {
+        return M{(MT)f(J)...};
+    }(std::make_index_sequence<nrelem<V>()>{});
+}
+
+/// Splits interleaved pairs of `lo` (pairs `0..N/2-1`) and `hi` (pairs `N/2..N-1`)
+/// into first elements `a` and second elements `b`.
+///
+/// Two two-source shuffles (`vpermt2ps` with AVX-512, `shufps` with SSE).
+template <typename V>
+void deinterleave2(const V lo, const V hi, V& a, V& b)
+{
+    constexpr auto even = lane_mask<V>([](std::size_t j) {return 2*j;});
+    constexpr auto odd  = lane_mask<V>([](std::size_t j) {return 2*j + 1;});
+    a = __builtin_shuffle(lo, hi, even);
+    b = __builtin_shuffle(lo, hi, odd);
+}
+
+/// Merges `a` and `b` into interleaved pairs `(a[j], b[j])`, inverse of `deinterleave2`.
+template <typename V>
+void interleave2(const V a, const V b, V& lo, V& hi)
+{
+    constexpr std::size_t n = nrelem<V>();
+    constexpr auto first  = lane_mask<V>([](std::size_t j) {return (j % 2 ? n : 0) + j/2;});
+    constexpr auto second = lane_mask<V>([](std::size_t j) {return (j % 2 ? n : 0) + n/2 + j/2;});
+    lo = __builtin_shuffle(a, b, first);
+    hi = __builtin_shuffle(a, b, second);
+}
+
 } //namespace vx
 
@@ -8,15 +8,27 @@
 #pragma once
 
 #include <cstdint>
+#include <cassert>
 
 #include "vxtypes.hpp"
 #include "vxops.hpp"
-#include "vxadvops.hpp"
+#include "vxfun.hpp"
 
 namespace vx::mx {
 
 using Index = uint64_t;
 
+/// Default software prefetch distance, in rows of B, for `mulBy`.
+///
+/// Column walk of B jumps over a whole row on every element,
+/// hardware prefetcher does not follow such stride once it crosses a page.
+/// However, neighbouring columns share cache lines, so as long as
+/// `nrRows * 64` bytes of B fit into L2 the lines are already there.
+/// Calibrated with `mulBy<2>` on 1024x1024 F64 (AVX-512 host):
+/// distance 0: 8.2s, 4: 8.5s, 8: 8.5s, 16: 9.4s, 32: 10.1s.
+/// Hence prefetch is off by default, enable it for very tall B.
+const Index mulby_prefetch_distance = 0;
+
 template <typename T>
 struct Matrix
 {
@@ -111,7 +123,16 @@ void mul(Matrix<T>& c, const Matrix<T>& a, const Matrix<T>& b)
 }
 
 #ifdef __AVX2__
-template <Index chunkSz, typename T>
+/// Vectorized `mul`, rows of A are loaded and columns of B are gathered.
+///
+/// `prefetchDist` is how many rows of B ahead of the gather to prefetch,
+/// 0 disables software prefetch.
+///
+/// ```c++
+/// vx::mx::mulBy<2>(c, a, b);     // default prefetch distance
+/// vx::mx::mulBy<2, 16>(c, a, b); // prefetch 16 rows of B ahead
+/// ```
+template <Index chunkSz, Index prefetchDist = mulby_prefetch_distance, typename T>
 void mulBy(Matrix<T>& c, const Matrix<T>& a, const Matrix<T>& b)
 {
     assert(a.nrCols == b.nrRows);
@@ -122,14 +143,19 @@ void mulBy(Matrix<T>& c, const Matrix<T>& a, const Matrix<T>& b)
     Chunk ta, tb;
 
     GatherVec gather;
-    for (unsigned int i = 0; i < chunkSz; ++i) {gather[i] = i*b.nrCols;}
+    for (unsigned int i = 0; i < chunkSz; ++i) {gather[i] = i*b.nrCols;} // element indices
 
     for (Index row = 0; row < a.nrRows; ++row) {
         for (Index col = 0; col < b.nrCols; ++col) {
             c.at(col, row) = 0;
             for (Index i = 0; i < a.nrCols; i += chunkSz) {
+                if constexpr (prefetchDist != 0) {
+                    for (Index k = i + prefetchDist; k < i + prefetchDist + chunkSz and k < b.nrRows; ++k) {
+                        vx::prefetch(&b.at(col, k));
+                    }
+                }
                 vx::load(ta, &a.data[row*a.nrCols + i]);
-                vx::load_gather(tb, &b.data[i*b.nrCols + col], gather, sizeof(T));
+                vx::gather(tb, &b.data[i*b.nrCols + col], gather);
 
                 c.at(col, row) += vx::dot<T>(ta, tb);
             }
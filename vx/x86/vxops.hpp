@@ -18,6 +18,8 @@
 #pragma once
 
 #include <type_traits>
+#include <limits>
+#include <utility>
 //#include <concepts>
 
 #include "vxtypes.hpp"
@@ -47,16 +49,67 @@ struct opaque_int<T, std::enable_if_t<sizeof(T)==64> >
 
 
 /// Test all bits of all elements are 1.
-template<typename T, typename = std::enable_if_t<sizeof(T)==16>>
+template<typename T>
 int test_all_ones(T v) {
-    return _mm_test_all_ones((__m128i)v);
+    if constexpr (sizeof(T) == 8) {
+        return (uint64_t)v == ~0UL;
+    }
+#ifdef __SSE4_1__
+    else if constexpr (sizeof(T) == 16) {
+        return _mm_test_all_ones((__m128i)v);
+    }
+#endif
+#ifdef __AVX__
+    else if constexpr (sizeof(T) == 32) {
+        return _mm256_testc_si256((__m256i)v, _mm256_set1_epi32(-1));
+    }
+#endif
+#ifdef __AVX512F__
+    else if constexpr (sizeof(T) == 64) {
+        return _mm512_cmpneq_epi64_mask((__m512i)v, _mm512_set1_epi64(-1)) == 0;
+    }
+#endif
+    else {
+        auto u = (typename make<uint64_t, sizeof(T)/8>::type)v;
+        for (unsigned i = 0; i < nrelem<decltype(u)>(); ++i) {
+            if (u[i] != ~0UL) return 0;
+        }
+        return 1;
+    }
 }
 
 
-/// Test all bits of all elements are 0.
-template<typename T, typename = std::enable_if_t<sizeof(T)==16>>
-int test_all_zeros(T v, uint128_t m = -1) {
-    return _mm_test_all_zeros((__m128i)v, (__m128i)m);
+/// Test all bits of all elements are 0, only bits set in `m` are tested.
+template<typename T, typename M = T>
+int test_all_zeros(T v, M m = (M)~(typename opaque_int<M>::type){}) {
+    static_assert(sizeof(M) == sizeof(T));
+
+    if constexpr (sizeof(T) == 8) {
+        return ((uint64_t)v & (uint64_t)m) == 0;
+    }
+#ifdef __SSE4_1__
+    else if constexpr (sizeof(T) == 16) {
+        return _mm_test_all_zeros((__m128i)v, (__m128i)m);
+    }
+#endif
+#ifdef __AVX__
+    else if constexpr (sizeof(T) == 32) {
+        return _mm256_testz_si256((__m256i)v, (__m256i)m);
+    }
+#endif
+#ifdef __AVX512F__
+    else if constexpr (sizeof(T) == 64) {
+        return _mm512_test_epi64_mask((__m512i)v, (__m512i)m) == 0;
+    }
+#endif
+    else {
+        using U = typename make<uint64_t, sizeof(T)/8>::type;
+        U u = (U)v & (U)m;
+        for (unsigned i = 0; i < nrelem<U>(); ++i) {
+            if (u[i] != 0) return 0;
+        }
+        return 1;
+    }
 }
 
 //template<typename T>
@@ -77,70 +130,1542 @@ void fill_zero(T& v) {
     fill_zero_i((typename opaque_int<T>::type &)v);
 }
 
-static inline void fill_zero(F32x4& v) {v = _mm_setzero_ps();}
-static inline void fill_zero(F32x8& v) {v = _mm256_setzero_ps();}
-static inline void fill_zero(F64x4& v) {v = _mm256_setzero_pd();}
-static inline void fill_zero(F64x8& v) {v = _mm512_setzero_pd();}
+/// Set all elements of floating point vector to 0.0.
+template<typename T,
+    typename = std::enable_if_t<
+        std::is_floating_point_v<typename get_base<T>::type>
+        >,
+    typename = void
+    >
+void fill_zero(T& v) {
+    v = (T){};
+}
 
 /// Set a single value to all elements.
-static inline void fill(F32x4& v, float n) {v = _mm_set1_ps(n);}
-static inline void fill(F32x8& v, float n) {v = _mm256_set1_ps(n);}
-static inline void fill(F64x4& v, double n) {v = _mm256_set1_pd(n);}
-static inline void fill(F64x8& v, double n) {v = _mm512_set1_pd(n);}
-
-static inline void fill(U32x4& v, uint32_t n) {v = (U32x4)_mm_set1_epi32(n);}
-
-/// Load vector from memory.
-static inline void load(F32x4& v, const float* mem) {v = _mm_load_ps(mem);}
-static inline void load(F32x8& v, const float* mem) {v = _mm256_load_ps(mem);}
-static inline void load(F32x16& v, const float* mem) {v = _mm512_load_ps(mem);}
-static inline void load(F64x2& v, const double* mem) {v = _mm_load_pd(mem);}
+///
+/// Example:
+/// ```c++
+/// F64x4 a;
+/// vx::fill(a, 7.0);
+/// ```
+template <typename V>
+void fill(V& v, typename get_base<V>::type n) {
+    v = n - (V){}; // broadcast, n - 0 keeps sign of -0.0
+}
+
+/// Returns vector with all elements set to `n`.
+///
+/// Example:
+/// ```c++
+/// F64x4 half = vx::broadcast<F64x4>(0.5);
+/// ```
+template <typename V>
+V broadcast(typename get_base<V>::type n) {
+    V v;
+    fill(v, n);
+    return v;
+}
+
+/// Returns mask with the first `n` elements set, rest of elements cleared.
+///
+/// Handy for processing the tail of a buffer with `maskload`/`maskstore`.
+///
+/// Example:
+/// ```c++
+/// assert(equal(mask_first_n<I32x4>(3), (I32x4){-1,-1,-1,0}));
+/// ```
+template <typename M>
+M mask_first_n(unsigned n)
+{
+    using T = typename get_base<M>::type;
+    M idx;
+    for (unsigned i = 0; i < nrelem<M>(); ++i) { idx[i] = (T)i; }
+    return idx < (T)n;
+}
+
+/// Load vector from memory aligned to the vector size.
+///
+/// Example:
+/// ```c++
+/// alignas(16) int32_t a[4] = {1,2,3,4};
+/// I32x4 v;
+/// vx::load(v, a);
+/// ```
+template <typename V>
+void load(V& v, const typename get_base<V>::type* mem)
+{
+    using T = typename get_base<V>::type;
+
+    if constexpr (sizeof(V) == 16) {
+        if constexpr (std::is_same_v<T, float>) { v = (V)_mm_load_ps(mem); }
+        else if constexpr (std::is_same_v<T, double>) { v = (V)_mm_load_pd(mem); }
+        else { v = (V)_mm_load_si128((const __m128i*)mem); }
+    }
+#ifdef __AVX__
+    else if constexpr (sizeof(V) == 32) {
+        if constexpr (std::is_same_v<T, float>) { v = (V)_mm256_load_ps(mem); }
+        else if constexpr (std::is_same_v<T, double>) { v = (V)_mm256_load_pd(mem); }
+        else { v = (V)_mm256_load_si256((const __m256i*)mem); }
+    }
+#endif
+#ifdef __AVX512F__
+    else if constexpr (sizeof(V) == 64) {
+        if constexpr (std::is_same_v<T, float>) { v = (V)_mm512_load_ps(mem); }
+        else if constexpr (std::is_same_v<T, double>) { v = (V)_mm512_load_pd(mem); }
+        else { v = (V)_mm512_load_si512(mem); }
+    }
+#endif
+    else {
+        __builtin_memcpy(&v, __builtin_assume_aligned(mem, sizeof(V)), sizeof(V));
+    }
+}
+
+/// Load vector from memory without alignment requirement.
+template <typename V>
+void loadu(V& v, const typename get_base<V>::type* mem)
+{
+    using T = typename get_base<V>::type;
+
+    if constexpr (sizeof(V) == 16) {
+        if constexpr (std::is_same_v<T, float>) { v = (V)_mm_loadu_ps(mem); }
+        else if constexpr (std::is_same_v<T, double>) { v = (V)_mm_loadu_pd(mem); }
+        else { v = (V)_mm_loadu_si128((const __m128i*)mem); }
+    }
+#ifdef __AVX__
+    else if constexpr (sizeof(V) == 32) {
+        if constexpr (std::is_same_v<T, float>) { v = (V)_mm256_loadu_ps(mem); }
+        else if constexpr (std::is_same_v<T, double>) { v = (V)_mm256_loadu_pd(mem); }
+        else { v = (V)_mm256_loadu_si256((const __m256i*)mem); }
+    }
+#endif
+#ifdef __AVX512F__
+    else if constexpr (sizeof(V) == 64) {
+        if constexpr (std::is_same_v<T, float>) { v = (V)_mm512_loadu_ps(mem); }
+        else if constexpr (std::is_same_v<T, double>) { v = (V)_mm512_loadu_pd(mem); }
+        else { v = (V)_mm512_loadu_si512(mem); }
+    }
+#endif
+    else {
+        __builtin_memcpy(&v, mem, sizeof(V));
+    }
+}
+
+/// Loads `nrelem<V>()` narrower elements without alignment requirement and
+/// zero or sign extends them to the elements of `V` (`pmovzx`/`pmovsx`).
+///
+/// Example:
+/// ```c++
+/// I32x8 v;
+/// vx::loadu_widen(v, bytes); // 8 uint8_t to int32_t
+/// ```
+template <typename V, typename T>
+void loadu_widen(V& v, const T* mem)
+{
+    using E = typename get_base<V>::type;
+    static_assert(std::is_integral_v<T> and sizeof(T) < sizeof(E));
+    using W = typename make<std::conditional_t<std::is_signed_v<T>,
+        std::make_signed_t<E>, std::make_unsigned_t<E>>, nrelem<V>()>::type;
+    [[maybe_unused]] constexpr bool s = std::is_signed_v<T>;
+
+    if constexpr (false) {}
+#ifdef __SSE4_1__
+    else if constexpr (sizeof(T) == 1 and sizeof(E) == 4 and sizeof(V) == 16) {
+        int32_t b; __builtin_memcpy(&b, mem, 4);
+        const __m128i x = _mm_cvtsi32_si128(b);
+        v = (V)(s ? _mm_cvtepi8_epi32(x) : _mm_cvtepu8_epi32(x));
+    }
+    else if constexpr (sizeof(T) == 2 and sizeof(E) == 4 and sizeof(V) == 16) {
+        const __m128i x = _mm_loadl_epi64((const __m128i*)mem);
+        v = (V)(s ? _mm_cvtepi16_epi32(x) : _mm_cvtepu16_epi32(x));
+    }
+#endif
+#ifdef __AVX2__
+    else if constexpr (sizeof(T) == 1 and sizeof(E) == 4 and sizeof(V) == 32) {
+        const __m128i x = _mm_loadl_epi64((const __m128i*)mem);
+        v = (V)(s ? _mm256_cvtepi8_epi32(x) : _mm256_cvtepu8_epi32(x));
+    }
+    else if constexpr (sizeof(T) == 2 and sizeof(E) == 4 and sizeof(V) == 32) {
+        const __m128i x = _mm_loadu_si128((const __m128i*)mem);
+        v = (V)(s ? _mm256_cvtepi16_epi32(x) : _mm256_cvtepu16_epi32(x));
+    }
+#endif
+#ifdef __AVX512F__
+    else if constexpr (sizeof(T) == 1 and sizeof(E) == 4 and sizeof(V) == 64) {
+        const __m128i x = _mm_loadu_si128((const __m128i*)mem);
+        v = (V)(s ? _mm512_maskz_cvtepi8_epi32(0xFFFF, x) : _mm512_maskz_cvtepu8_epi32(0xFFFF, x)); // see min
+    }
+    else if constexpr (sizeof(T) == 2 and sizeof(E) == 4 and sizeof(V) == 64) {
+        const __m256i x = _mm256_loadu_si256((const __m256i*)mem);
+        v = (V)(s ? _mm512_maskz_cvtepi16_epi32(0xFFFF, x) : _mm512_maskz_cvtepu16_epi32(0xFFFF, x)); // see min
+    }
+#endif
+    else {
+        typename make<T, nrelem<V>()>::type n;
+        __builtin_memcpy(&n, mem, sizeof(n));
+        v = (V)__builtin_convertvector(n, W);
+    }
+}
+
+/// Store vector to memory aligned to the vector size.
+template <typename V>
+void store(typename get_base<V>::type* mem, const V& v)
+{
+    using T = typename get_base<V>::type;
+
+    if constexpr (sizeof(V) == 16) {
+        if constexpr (std::is_same_v<T, float>) { _mm_store_ps(mem, (__m128)v); }
+        else if constexpr (std::is_same_v<T, double>) { _mm_store_pd(mem, (__m128d)v); }
+        else { _mm_store_si128((__m128i*)mem, (__m128i)v); }
+    }
+#ifdef __AVX__
+    else if constexpr (sizeof(V) == 32) {
+        if constexpr (std::is_same_v<T, float>) { _mm256_store_ps(mem, (__m256)v); }
+        else if constexpr (std::is_same_v<T, double>) { _mm256_store_pd(mem, (__m256d)v); }
+        else { _mm256_store_si256((__m256i*)mem, (__m256i)v); }
+    }
+#endif
+#ifdef __AVX512F__
+    else if constexpr (sizeof(V) == 64) {
+        if constexpr (std::is_same_v<T, float>) { _mm512_store_ps(mem, (__m512)v); }
+        else if constexpr (std::is_same_v<T, double>) { _mm512_store_pd(mem, (__m512d)v); }
+        else { _mm512_store_si512(mem, (__m512i)v); }
+    }
+#endif
+    else {
+        __builtin_memcpy(__builtin_assume_aligned(mem, sizeof(V)), &v, sizeof(V));
+    }
+}
+
+/// Store vector to memory without alignment requirement.
+template <typename V>
+void storeu(typename get_base<V>::type* mem, const V& v)
+{
+    using T = typename get_base<V>::type;
+
+    if constexpr (sizeof(V) == 16) {
+        if constexpr (std::is_same_v<T, float>) { _mm_storeu_ps(mem, (__m128)v); }
+        else if constexpr (std::is_same_v<T, double>) { _mm_storeu_pd(mem, (__m128d)v); }
+        else { _mm_storeu_si128((__m128i*)mem, (__m128i)v); }
+    }
+#ifdef __AVX__
+    else if constexpr (sizeof(V) == 32) {
+        if constexpr (std::is_same_v<T, float>) { _mm256_storeu_ps(mem, (__m256)v); }
+        else if constexpr (std::is_same_v<T, double>) { _mm256_storeu_pd(mem, (__m256d)v); }
+        else { _mm256_storeu_si256((__m256i*)mem, (__m256i)v); }
+    }
+#endif
+#ifdef __AVX512F__
+    else if constexpr (sizeof(V) == 64) {
+        if constexpr (std::is_same_v<T, float>) { _mm512_storeu_ps(mem, (__m512)v); }
+        else if constexpr (std::is_same_v<T, double>) { _mm512_storeu_pd(mem, (__m512d)v); }
+        else { _mm512_storeu_si512(mem, (__m512i)v); }
+    }
+#endif
+    else {
+        __builtin_memcpy(mem, &v, sizeof(V));
+    }
+}
+
+/// Load elements selected by mask, other elements are set to 0.
+///
+/// Memory of not selected elements is not accessed, so it is safe
+/// to load the tail of a buffer that ends right before unmapped page.
+///
+/// Example:
+/// ```c++
+/// float a[3] = {1,2,3};
+/// F32x4 v;
+/// vx::maskload(v, a, mask_first_n<I32x4>(3)); // v == {1,2,3,0}
+/// ```
+template <typename V>
+void maskload(V& v, const typename get_base<V>::type* mem, typename get_mask<V>::type m)
+{
+    using T = typename get_base<V>::type;
+    [[maybe_unused]] constexpr std::size_t esz = sizeof(T);
+
+    if constexpr (false) {}
+#ifdef __AVX2__
+    else if constexpr (sizeof(V) == 16 and std::is_same_v<T, float>) {
+        v = (V)_mm_maskload_ps(mem, (__m128i)m); }
+    else if constexpr (sizeof(V) == 16 and std::is_same_v<T, double>) {
+        v = (V)_mm_maskload_pd(mem, (__m128i)m); }
+    else if constexpr (sizeof(V) == 16 and esz == 4) {
+        v = (V)_mm_maskload_epi32((const int*)mem, (__m128i)m); }
+    else if constexpr (sizeof(V) == 16 and esz == 8) {
+        v = (V)_mm_maskload_epi64((const long long*)mem, (__m128i)m); }
+    else if constexpr (sizeof(V) == 32 and std::is_same_v<T, float>) {
+        v = (V)_mm256_maskload_ps(mem, (__m256i)m); }
+    else if constexpr (sizeof(V) == 32 and std::is_same_v<T, double>) {
+        v = (V)_mm256_maskload_pd(mem, (__m256i)m); }
+    else if constexpr (sizeof(V) == 32 and esz == 4) {
+        v = (V)_mm256_maskload_epi32((const int*)mem, (__m256i)m); }
+    else if constexpr (sizeof(V) == 32 and esz == 8) {
+        v = (V)_mm256_maskload_epi64((const long long*)mem, (__m256i)m); }
+#endif
+#if defined(__AVX512BW__) && defined(__AVX512VL__)
+    else if constexpr (sizeof(V) == 16 and esz == 1) {
+        v = (V)_mm_maskz_loadu_epi8(_mm_movepi8_mask((__m128i)m), mem); }
+    else if constexpr (sizeof(V) == 16 and esz == 2) {
+        v = (V)_mm_maskz_loadu_epi16(_mm_movepi16_mask((__m128i)m), mem); }
+    else if constexpr (sizeof(V) == 32 and esz == 1) {
+        v = (V)_mm256_maskz_loadu_epi8(_mm256_movepi8_mask((__m256i)m), mem); }
+    else if constexpr (sizeof(V) == 32 and esz == 2) {
+        v = (V)_mm256_maskz_loadu_epi16(_mm256_movepi16_mask((__m256i)m), mem); }
+#endif
+#ifdef __AVX512BW__
+    else if constexpr (sizeof(V) == 64 and esz == 1) {
+        v = (V)_mm512_maskz_loadu_epi8(_mm512_movepi8_mask((__m512i)m), mem); }
+    else if constexpr (sizeof(V) == 64 and esz == 2) {
+        v = (V)_mm512_maskz_loadu_epi16(_mm512_movepi16_mask((__m512i)m), mem); }
+#endif
+#ifdef __AVX512F__
+    else if constexpr (sizeof(V) == 64 and esz == 4) {
+        __mmask16 k = _mm512_cmplt_epi32_mask((__m512i)m, _mm512_setzero_si512());
+        v = (V)_mm512_maskz_loadu_epi32(k, mem); }
+    else if constexpr (sizeof(V) == 64 and esz == 8) {
+        __mmask8 k = _mm512_cmplt_epi64_mask((__m512i)m, _mm512_setzero_si512());
+        v = (V)_mm512_maskz_loadu_epi64(k, mem); }
+#endif
+    else {
+        V r{}; // lanes are written one by one, start from defined value
+        for (unsigned i = 0; i < nrelem<V>(); ++i) {
+            if (m[i]) r[i] = mem[i];
+        }
+        v = r;
+    }
+}
+
+/// Store elements selected by mask, memory of other elements is not touched.
+///
+/// Example:
+/// ```c++
+/// float a[3];
+/// vx::maskstore(a, (F32x4){1,2,3,4}, mask_first_n<I32x4>(3)); // a == {1,2,3}
+/// ```
+template <typename V>
+void maskstore(typename get_base<V>::type* mem, const V& v, typename get_mask<V>::type m)
+{
+    using T = typename get_base<V>::type;
+    [[maybe_unused]] constexpr std::size_t esz = sizeof(T);
+
+    if constexpr (false) {}
+#ifdef __AVX2__
+    else if constexpr (sizeof(V) == 16 and std::is_same_v<T, float>) {
+        _mm_maskstore_ps(mem, (__m128i)m, (__m128)v); }
+    else if constexpr (sizeof(V) == 16 and std::is_same_v<T, double>) {
+        _mm_maskstore_pd(mem, (__m128i)m, (__m128d)v); }
+    else if constexpr (sizeof(V) == 16 and esz == 4) {
+        _mm_maskstore_epi32((int*)mem, (__m128i)m, (__m128i)v); }
+    else if constexpr (sizeof(V) == 16 and esz == 8) {
+        _mm_maskstore_epi64((long long*)mem, (__m128i)m, (__m128i)v); }
+    else if constexpr (sizeof(V) == 32 and std::is_same_v<T, float>) {
+        _mm256_maskstore_ps(mem, (__m256i)m, (__m256)v); }
+    else if constexpr (sizeof(V) == 32 and std::is_same_v<T, double>) {
+        _mm256_maskstore_pd(mem, (__m256i)m, (__m256d)v); }
+    else if constexpr (sizeof(V) == 32 and esz == 4) {
+        _mm256_maskstore_epi32((int*)mem, (__m256i)m, (__m256i)v); }
+    else if constexpr (sizeof(V) == 32 and esz == 8) {
+        _mm256_maskstore_epi64((long long*)mem, (__m256i)m, (__m256i)v); }
+#endif
+#if defined(__AVX512BW__) && defined(__AVX512VL__)
+    else if constexpr (sizeof(V) == 16 and esz == 1) {
+        _mm_mask_storeu_epi8(mem, _mm_movepi8_mask((__m128i)m), (__m128i)v); }
+    else if constexpr (sizeof(V) == 16 and esz == 2) {
+        _mm_mask_storeu_epi16(mem, _mm_movepi16_mask((__m128i)m), (__m128i)v); }
+    else if constexpr (sizeof(V) == 32 and esz == 1) {
+        _mm256_mask_storeu_epi8(mem, _mm256_movepi8_mask((__m256i)m), (__m256i)v); }
+    else if constexpr (sizeof(V) == 32 and esz == 2) {
+        _mm256_mask_storeu_epi16(mem, _mm256_movepi16_mask((__m256i)m), (__m256i)v); }
+#endif
+#ifdef __AVX512BW__
+    else if constexpr (sizeof(V) == 64 and esz == 1) {
+        _mm512_mask_storeu_epi8(mem, _mm512_movepi8_mask((__m512i)m), (__m512i)v); }
+    else if constexpr (sizeof(V) == 64 and esz == 2) {
+        _mm512_mask_storeu_epi16(mem, _mm512_movepi16_mask((__m512i)m), (__m512i)v); }
+#endif
+#ifdef __AVX512F__
+    else if constexpr (sizeof(V) == 64 and esz == 4) {
+        __mmask16 k = _mm512_cmplt_epi32_mask((__m512i)m, _mm512_setzero_si512());
+        _mm512_mask_storeu_epi32(mem, k, (__m512i)v); }
+    else if constexpr (sizeof(V) == 64 and esz == 8) {
+        __mmask8 k = _mm512_cmplt_epi64_mask((__m512i)m, _mm512_setzero_si512());
+        _mm512_mask_storeu_epi64(mem, k, (__m512i)v); }
+#endif
+    else {
+        for (unsigned i = 0; i < nrelem<V>(); ++i) {
+            if (m[i]) mem[i] = v[i];
+        }
+    }
+}
+
+/// True if vector `V` is `S` bytes long and has elements of type `T`.
+template <typename V, std::size_t S, typename T>
+constexpr bool is_vec = (sizeof(V) == S and std::is_same_v<typename get_base<V>::type, T>);
+
+/// Add elements, `a[i] + b[i]`.
+///
+/// GCC defines `_mm*_add_*`, `_mm*_sub_*`, `_mm*_mul_*` and `_mm*_div_*`
+/// intrinsics as vector extension arithmetic, so `add`, `sub`, `mul` and `div`
+/// are written the same way and get the best instruction of enabled ISA
+/// for every type, for example `vpmullq` for `I64x8` with AVX512DQ.
+template <typename V> V add(const V a, const V b) {return a + b;}
+
+/// Subtract elements, `a[i] - b[i]`.
+template <typename V> V sub(const V a, const V b) {return a - b;}
+
+/// Multiply elements, low half of the product for integers.
+template <typename V> V mul(const V a, const V b) {return a * b;}
+
+/// Divide elements.
+///
+/// @attention There is no integer vector division instruction,
+/// integer vectors are divided one element at a time.
+template <typename V> V div(const V a, const V b) {return a / b;}
+
+/// Minimum of elements.
+///
+/// For floating point `min(a, b)` is `a < b ? a : b`, like `minps`,
+/// it returns `b` if either element is NaN.
+template <typename V>
+V min(const V a, const V b)
+{
+    if constexpr (false) {}
+    else if constexpr (is_vec<V,16,float>)    {return (V)_mm_min_ps((__m128)a, (__m128)b);}
+    else if constexpr (is_vec<V,16,double>)   {return (V)_mm_min_pd((__m128d)a, (__m128d)b);}
+    else if constexpr (is_vec<V,16,uint8_t>)  {return (V)_mm_min_epu8((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,16,int16_t>)  {return (V)_mm_min_epi16((__m128i)a, (__m128i)b);}
+#ifdef __SSE4_1__
+    else if constexpr (is_vec<V,16,int8_t>)   {return (V)_mm_min_epi8((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,16,uint16_t>) {return (V)_mm_min_epu16((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,16,int32_t>)  {return (V)_mm_min_epi32((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,16,uint32_t>) {return (V)_mm_min_epu32((__m128i)a, (__m128i)b);}
+#endif
+#ifdef __AVX__
+    else if constexpr (is_vec<V,32,float>)    {return (V)_mm256_min_ps((__m256)a, (__m256)b);}
+    else if constexpr (is_vec<V,32,double>)   {return (V)_mm256_min_pd((__m256d)a, (__m256d)b);}
+#endif
+#ifdef __AVX2__
+    else if constexpr (is_vec<V,32,int8_t>)   {return (V)_mm256_min_epi8((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,uint8_t>)  {return (V)_mm256_min_epu8((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,int16_t>)  {return (V)_mm256_min_epi16((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,uint16_t>) {return (V)_mm256_min_epu16((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,int32_t>)  {return (V)_mm256_min_epi32((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,uint32_t>) {return (V)_mm256_min_epu32((__m256i)a, (__m256i)b);}
+#endif
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+    else if constexpr (is_vec<V,16,int64_t>)  {return (V)_mm_min_epi64((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,16,uint64_t>) {return (V)_mm_min_epu64((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,32,int64_t>)  {return (V)_mm256_min_epi64((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,uint64_t>) {return (V)_mm256_min_epu64((__m256i)a, (__m256i)b);}
+#endif
+#ifdef __AVX512F__
+    // maskz forms with full mask: plain forms take _mm512_undefined source,
+    // GCC 12 -Wmaybe-uninitialized trips on it.
+    else if constexpr (is_vec<V,64,float>)    {return (V)_mm512_maskz_min_ps(0xFFFF, (__m512)a, (__m512)b);}
+    else if constexpr (is_vec<V,64,double>)   {return (V)_mm512_maskz_min_pd(0xFF, (__m512d)a, (__m512d)b);}
+    else if constexpr (is_vec<V,64,int32_t>)  {return (V)_mm512_maskz_min_epi32(0xFFFF, (__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,uint32_t>) {return (V)_mm512_maskz_min_epu32(0xFFFF, (__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,int64_t>)  {return (V)_mm512_maskz_min_epi64(0xFF, (__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,uint64_t>) {return (V)_mm512_maskz_min_epu64(0xFF, (__m512i)a, (__m512i)b);}
+#endif
+#ifdef __AVX512BW__
+    else if constexpr (is_vec<V,64,int8_t>)   {return (V)_mm512_min_epi8((__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,uint8_t>)  {return (V)_mm512_min_epu8((__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,int16_t>)  {return (V)_mm512_min_epi16((__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,uint16_t>) {return (V)_mm512_min_epu16((__m512i)a, (__m512i)b);}
+#endif
+    else {
+        return a < b ? a : b;
+    }
+}
+
+/// Maximum of elements.
+///
+/// For floating point `max(a, b)` is `a > b ? a : b`, like `maxps`,
+/// it returns `b` if either element is NaN.
+template <typename V>
+V max(const V a, const V b)
+{
+    if constexpr (false) {}
+    else if constexpr (is_vec<V,16,float>)    {return (V)_mm_max_ps((__m128)a, (__m128)b);}
+    else if constexpr (is_vec<V,16,double>)   {return (V)_mm_max_pd((__m128d)a, (__m128d)b);}
+    else if constexpr (is_vec<V,16,uint8_t>)  {return (V)_mm_max_epu8((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,16,int16_t>)  {return (V)_mm_max_epi16((__m128i)a, (__m128i)b);}
+#ifdef __SSE4_1__
+    else if constexpr (is_vec<V,16,int8_t>)   {return (V)_mm_max_epi8((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,16,uint16_t>) {return (V)_mm_max_epu16((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,16,int32_t>)  {return (V)_mm_max_epi32((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,16,uint32_t>) {return (V)_mm_max_epu32((__m128i)a, (__m128i)b);}
+#endif
+#ifdef __AVX__
+    else if constexpr (is_vec<V,32,float>)    {return (V)_mm256_max_ps((__m256)a, (__m256)b);}
+    else if constexpr (is_vec<V,32,double>)   {return (V)_mm256_max_pd((__m256d)a, (__m256d)b);}
+#endif
+#ifdef __AVX2__
+    else if constexpr (is_vec<V,32,int8_t>)   {return (V)_mm256_max_epi8((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,uint8_t>)  {return (V)_mm256_max_epu8((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,int16_t>)  {return (V)_mm256_max_epi16((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,uint16_t>) {return (V)_mm256_max_epu16((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,int32_t>)  {return (V)_mm256_max_epi32((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,uint32_t>) {return (V)_mm256_max_epu32((__m256i)a, (__m256i)b);}
+#endif
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+    else if constexpr (is_vec<V,16,int64_t>)  {return (V)_mm_max_epi64((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,16,uint64_t>) {return (V)_mm_max_epu64((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,32,int64_t>)  {return (V)_mm256_max_epi64((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,uint64_t>) {return (V)_mm256_max_epu64((__m256i)a, (__m256i)b);}
+#endif
+#ifdef __AVX512F__
+    else if constexpr (is_vec<V,64,float>)    {return (V)_mm512_maskz_max_ps(0xFFFF, (__m512)a, (__m512)b);}
+    else if constexpr (is_vec<V,64,double>)   {return (V)_mm512_maskz_max_pd(0xFF, (__m512d)a, (__m512d)b);}
+    else if constexpr (is_vec<V,64,int32_t>)  {return (V)_mm512_maskz_max_epi32(0xFFFF, (__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,uint32_t>) {return (V)_mm512_maskz_max_epu32(0xFFFF, (__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,int64_t>)  {return (V)_mm512_maskz_max_epi64(0xFF, (__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,uint64_t>) {return (V)_mm512_maskz_max_epu64(0xFF, (__m512i)a, (__m512i)b);}
+#endif
+#ifdef __AVX512BW__
+    else if constexpr (is_vec<V,64,int8_t>)   {return (V)_mm512_max_epi8((__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,uint8_t>)  {return (V)_mm512_max_epu8((__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,int16_t>)  {return (V)_mm512_max_epi16((__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,uint16_t>) {return (V)_mm512_max_epu16((__m512i)a, (__m512i)b);}
+#endif
+    else {
+        return a > b ? a : b;
+    }
+}
+
+/// Absolute value of elements.
+///
+/// Floating point abs clears the sign bit, so `abs(-0.0) == 0.0`.
+/// Integer abs of the minimum value wraps around, `abs(-128) == -128`.
+template <typename V>
+V abs(const V a)
+{
+    using T = typename get_base<V>::type;
+
+    if constexpr (std::is_unsigned_v<T>) {return a;}
+#ifdef __SSSE3__
+    else if constexpr (is_vec<V,16,int8_t>)   {return (V)_mm_abs_epi8((__m128i)a);}
+    else if constexpr (is_vec<V,16,int16_t>)  {return (V)_mm_abs_epi16((__m128i)a);}
+    else if constexpr (is_vec<V,16,int32_t>)  {return (V)_mm_abs_epi32((__m128i)a);}
+#endif
+#ifdef __AVX2__
+    else if constexpr (is_vec<V,32,int8_t>)   {return (V)_mm256_abs_epi8((__m256i)a);}
+    else if constexpr (is_vec<V,32,int16_t>)  {return (V)_mm256_abs_epi16((__m256i)a);}
+    else if constexpr (is_vec<V,32,int32_t>)  {return (V)_mm256_abs_epi32((__m256i)a);}
+#endif
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+    else if constexpr (is_vec<V,16,int64_t>)  {return (V)_mm_abs_epi64((__m128i)a);}
+    else if constexpr (is_vec<V,32,int64_t>)  {return (V)_mm256_abs_epi64((__m256i)a);}
+#endif
+#ifdef __AVX512F__
+    else if constexpr (is_vec<V,64,float>)    {return (V)_mm512_abs_ps((__m512)a);}
+    else if constexpr (is_vec<V,64,double>)   {return (V)_mm512_abs_pd((__m512d)a);}
+    else if constexpr (is_vec<V,64,int32_t>)  {return (V)_mm512_abs_epi32((__m512i)a);}
+    else if constexpr (is_vec<V,64,int64_t>)  {return (V)_mm512_abs_epi64((__m512i)a);}
+#endif
+#ifdef __AVX512BW__
+    else if constexpr (is_vec<V,64,int8_t>)   {return (V)_mm512_abs_epi8((__m512i)a);}
+    else if constexpr (is_vec<V,64,int16_t>)  {return (V)_mm512_abs_epi16((__m512i)a);}
+#endif
+    else if constexpr (std::is_floating_point_v<T>) {
+        using M = typename get_mask<V>::type;
+        using MT = typename get_base<M>::type;
+        return (V)((M)a & std::numeric_limits<MT>::max()); // clear sign bit
+    }
+    else {
+        return a < 0 ? -a : a;
+    }
+}
+
+/// Add elements with saturation, `a[i] + b[i]` clamped to range of element type.
+///
+/// SSE and AVX have saturating add for 8- and 16-bit elements only,
+/// 32- and 64-bit elements detect overflow with vector logic.
+template <typename V>
+V add_saturated(const V a, const V b)
+{
+    using T = typename get_base<V>::type;
+
+    if constexpr (false) {}
+    else if constexpr (is_vec<V,16,int8_t>)   {return (V)_mm_adds_epi8((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,16,uint8_t>)  {return (V)_mm_adds_epu8((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,16,int16_t>)  {return (V)_mm_adds_epi16((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,16,uint16_t>) {return (V)_mm_adds_epu16((__m128i)a, (__m128i)b);}
+    else if constexpr (sizeof(V) == 8 and sizeof(T) <= 2) {
+        // use lower half of 128-bit register
+        using W = typename make<T, 2*nrelem<V>()>::type;
+        W r = add_saturated((W)_mm_cvtsi64_si128((int64_t)a), (W)_mm_cvtsi64_si128((int64_t)b));
+        return (V)_mm_cvtsi128_si64((__m128i)r);
+    }
+#ifdef __AVX2__
+    else if constexpr (is_vec<V,32,int8_t>)   {return (V)_mm256_adds_epi8((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,uint8_t>)  {return (V)_mm256_adds_epu8((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,int16_t>)  {return (V)_mm256_adds_epi16((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,uint16_t>) {return (V)_mm256_adds_epu16((__m256i)a, (__m256i)b);}
+#endif
+#ifdef __AVX512BW__
+    else if constexpr (is_vec<V,64,int8_t>)   {return (V)_mm512_adds_epi8((__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,uint8_t>)  {return (V)_mm512_adds_epu8((__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,int16_t>)  {return (V)_mm512_adds_epi16((__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,uint16_t>) {return (V)_mm512_adds_epu16((__m512i)a, (__m512i)b);}
+#endif
+    else if constexpr (std::is_unsigned_v<T>) {
+        V s = a + b;
+        return s < a ? (V)~(V){} : s;
+    }
+    else {
+        using U = typename make<std::make_unsigned_t<T>, nrelem<V>()>::type;
+        V s = (V)((U)a + (U)b); // wrap around
+        V limit = (a >> (sizeof(T)*8 - 1)) ^ std::numeric_limits<T>::max(); // MAX or MIN
+        return ((a ^ s) & (b ^ s)) < 0 ? limit : s;
+    }
+}
+
+/// Subtract elements with saturation, `a[i] - b[i]` clamped to range of element type.
+template <typename V>
+V sub_saturated(const V a, const V b)
+{
+    using T = typename get_base<V>::type;
+
+    if constexpr (false) {}
+    else if constexpr (is_vec<V,16,int8_t>)   {return (V)_mm_subs_epi8((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,16,uint8_t>)  {return (V)_mm_subs_epu8((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,16,int16_t>)  {return (V)_mm_subs_epi16((__m128i)a, (__m128i)b);}
+    else if constexpr (is_vec<V,16,uint16_t>) {return (V)_mm_subs_epu16((__m128i)a, (__m128i)b);}
+    else if constexpr (sizeof(V) == 8 and sizeof(T) <= 2) {
+        using W = typename make<T, 2*nrelem<V>()>::type;
+        W r = sub_saturated((W)_mm_cvtsi64_si128((int64_t)a), (W)_mm_cvtsi64_si128((int64_t)b));
+        return (V)_mm_cvtsi128_si64((__m128i)r);
+    }
+#ifdef __AVX2__
+    else if constexpr (is_vec<V,32,int8_t>)   {return (V)_mm256_subs_epi8((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,uint8_t>)  {return (V)_mm256_subs_epu8((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,int16_t>)  {return (V)_mm256_subs_epi16((__m256i)a, (__m256i)b);}
+    else if constexpr (is_vec<V,32,uint16_t>) {return (V)_mm256_subs_epu16((__m256i)a, (__m256i)b);}
+#endif
+#ifdef __AVX512BW__
+    else if constexpr (is_vec<V,64,int8_t>)   {return (V)_mm512_subs_epi8((__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,uint8_t>)  {return (V)_mm512_subs_epu8((__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,int16_t>)  {return (V)_mm512_subs_epi16((__m512i)a, (__m512i)b);}
+    else if constexpr (is_vec<V,64,uint16_t>) {return (V)_mm512_subs_epu16((__m512i)a, (__m512i)b);}
+#endif
+    else if constexpr (std::is_unsigned_v<T>) {
+        return a > b ? a - b : (V){};
+    }
+    else {
+        using U = typename make<std::make_unsigned_t<T>, nrelem<V>()>::type;
+        V d = (V)((U)a - (U)b); // wrap around
+        V limit = (a >> (sizeof(T)*8 - 1)) ^ std::numeric_limits<T>::max(); // MAX or MIN
+        return ((a ^ b) & (a ^ d)) < 0 ? limit : d;
+    }
+}
+
+/// Fused multiply-add, `a[i] * b[i] + c[i]` with a single rounding.
+///
+/// Without FMA instructions and for integers it is a multiply followed by an add.
+template <typename V>
+V madd(const V a, const V b, const V c)
+{
+    if constexpr (false) {}
+#ifdef __FMA__
+    else if constexpr (is_vec<V,16,float>)    {return (V)_mm_fmadd_ps((__m128)a, (__m128)b, (__m128)c);}
+    else if constexpr (is_vec<V,16,double>)   {return (V)_mm_fmadd_pd((__m128d)a, (__m128d)b, (__m128d)c);}
+    else if constexpr (is_vec<V,32,float>)    {return (V)_mm256_fmadd_ps((__m256)a, (__m256)b, (__m256)c);}
+    else if constexpr (is_vec<V,32,double>)   {return (V)_mm256_fmadd_pd((__m256d)a, (__m256d)b, (__m256d)c);}
+#endif
+#ifdef __AVX512F__
+    else if constexpr (is_vec<V,64,float>)    {return (V)_mm512_fmadd_ps((__m512)a, (__m512)b, (__m512)c);}
+    else if constexpr (is_vec<V,64,double>)   {return (V)_mm512_fmadd_pd((__m512d)a, (__m512d)b, (__m512d)c);}
+#endif
+    else {
+        return a * b + c;
+    }
+}
+
+/// Fused multiply-subtract, `a[i] * b[i] - c[i]`.
+template <typename V>
+V msub(const V a, const V b, const V c)
+{
+    if constexpr (false) {}
+#ifdef __FMA__
+    else if constexpr (is_vec<V,16,float>)    {return (V)_mm_fmsub_ps((__m128)a, (__m128)b, (__m128)c);}
+    else if constexpr (is_vec<V,16,double>)   {return (V)_mm_fmsub_pd((__m128d)a, (__m128d)b, (__m128d)c);}
+    else if constexpr (is_vec<V,32,float>)    {return (V)_mm256_fmsub_ps((__m256)a, (__m256)b, (__m256)c);}
+    else if constexpr (is_vec<V,32,double>)   {return (V)_mm256_fmsub_pd((__m256d)a, (__m256d)b, (__m256d)c);}
+#endif
+#ifdef __AVX512F__
+    else if constexpr (is_vec<V,64,float>)    {return (V)_mm512_fmsub_ps((__m512)a, (__m512)b, (__m512)c);}
+    else if constexpr (is_vec<V,64,double>)   {return (V)_mm512_fmsub_pd((__m512d)a, (__m512d)b, (__m512d)c);}
+#endif
+    else {
+        return a * b - c;
+    }
+}
+
+/// Fused negated multiply-add, `c[i] - a[i] * b[i]`.
+template <typename V>
+V nmadd(const V a, const V b, const V c)
+{
+    if constexpr (false) {}
+#ifdef __FMA__
+    else if constexpr (is_vec<V,16,float>)    {return (V)_mm_fnmadd_ps((__m128)a, (__m128)b, (__m128)c);}
+    else if constexpr (is_vec<V,16,double>)   {return (V)_mm_fnmadd_pd((__m128d)a, (__m128d)b, (__m128d)c);}
+    else if constexpr (is_vec<V,32,float>)    {return (V)_mm256_fnmadd_ps((__m256)a, (__m256)b, (__m256)c);}
+    else if constexpr (is_vec<V,32,double>)   {return (V)_mm256_fnmadd_pd((__m256d)a, (__m256d)b, (__m256d)c);}
+#endif
+#ifdef __AVX512F__
+    else if constexpr (is_vec<V,64,float>)    {return (V)_mm512_fnmadd_ps((__m512)a, (__m512)b, (__m512)c);}
+    else if constexpr (is_vec<V,64,double>)   {return (V)_mm512_fnmadd_pd((__m512d)a, (__m512d)b, (__m512d)c);}
+#endif
+    else {
+        return c - a * b;
+    }
+}
+
+/// `c` with sign of even (`Odd == false`) or odd elements flipped.
+template <bool Odd, typename V>
+V negate_alternate(const V c)
+{
+    using M = typename get_mask<V>::type;
+    using MT = typename get_base<M>::type;
+    constexpr MT sign = std::numeric_limits<MT>::min();
+    constexpr M flip = []<std::size_t... I>(std::index_sequence<I...>) {
+        return M{((I % 2 == (Odd ? 1 : 0)) ? sign : MT{})...};
+    }(std::make_index_sequence<nrelem<V>()>{});
+    return (V)((M)c ^ flip);
+}
+
+/// Fused multiply with alternating subtract/add, `a[i] * b[i] ∓ c[i]`:
+/// even elements subtract `c`, odd elements add it.
+///
+/// Complex multiply on interleaved `(re, im)` pairs is one `fmaddsub`,
+/// see `vx::cx::mul_interleaved`. Without FMA it is a multiply and `addsub`.
+template <typename V>
+V fmaddsub(const V a, const V b, const V c)
+{
+    if constexpr (false) {}
+#ifdef __FMA__
+    else if constexpr (is_vec<V,16,float>)    {return (V)_mm_fmaddsub_ps((__m128)a, (__m128)b, (__m128)c);}
+    else if constexpr (is_vec<V,16,double>)   {return (V)_mm_fmaddsub_pd((__m128d)a, (__m128d)b, (__m128d)c);}
+    else if constexpr (is_vec<V,32,float>)    {return (V)_mm256_fmaddsub_ps((__m256)a, (__m256)b, (__m256)c);}
+    else if constexpr (is_vec<V,32,double>)   {return (V)_mm256_fmaddsub_pd((__m256d)a, (__m256d)b, (__m256d)c);}
+#endif
+#ifdef __AVX512F__
+    else if constexpr (is_vec<V,64,float>)    {return (V)_mm512_fmaddsub_ps((__m512)a, (__m512)b, (__m512)c);}
+    else if constexpr (is_vec<V,64,double>)   {return (V)_mm512_fmaddsub_pd((__m512d)a, (__m512d)b, (__m512d)c);}
+#endif
+#ifdef __SSE3__
+    else if constexpr (is_vec<V,16,float>)    {return (V)_mm_addsub_ps((__m128)(a * b), (__m128)c);}
+    else if constexpr (is_vec<V,16,double>)   {return (V)_mm_addsub_pd((__m128d)(a * b), (__m128d)c);}
+#endif
+#ifdef __AVX__
+    else if constexpr (is_vec<V,32,float>)    {return (V)_mm256_addsub_ps((__m256)(a * b), (__m256)c);}
+    else if constexpr (is_vec<V,32,double>)   {return (V)_mm256_addsub_pd((__m256d)(a * b), (__m256d)c);}
+#endif
+    else {
+        return a * b + negate_alternate<false>(c);
+    }
+}
+
+/// Fused multiply with alternating add/subtract, `a[i] * b[i] ± c[i]`:
+/// even elements add `c`, odd elements subtract it.
+template <typename V>
+V fmsubadd(const V a, const V b, const V c)
+{
+    if constexpr (false) {}
+#ifdef __FMA__
+    else if constexpr (is_vec<V,16,float>)    {return (V)_mm_fmsubadd_ps((__m128)a, (__m128)b, (__m128)c);}
+    else if constexpr (is_vec<V,16,double>)   {return (V)_mm_fmsubadd_pd((__m128d)a, (__m128d)b, (__m128d)c);}
+    else if constexpr (is_vec<V,32,float>)    {return (V)_mm256_fmsubadd_ps((__m256)a, (__m256)b, (__m256)c);}
+    else if constexpr (is_vec<V,32,double>)   {return (V)_mm256_fmsubadd_pd((__m256d)a, (__m256d)b, (__m256d)c);}
+#endif
+#ifdef __AVX512F__
+    else if constexpr (is_vec<V,64,float>)    {return (V)_mm512_fmsubadd_ps((__m512)a, (__m512)b, (__m512)c);}
+    else if constexpr (is_vec<V,64,double>)   {return (V)_mm512_fmsubadd_pd((__m512d)a, (__m512d)b, (__m512d)c);}
+#endif
+    else {
+        return a * b + negate_alternate<true>(c);
+    }
+}
+
+/// High half of full product `a[i] * b[i]` of 16, 32 or 64-bit integer elements.
+///
+/// 16-bit elements have `pmulhuw`/`pmulhw`. Others are
+/// built from 32x32->64 bit unsigned multiplies (`pmuludq`): even and odd
+/// 32-bit lanes for 32-bit elements, four partial products for 64-bit
+/// elements. Signed product is unsigned one corrected by `a<0 ? b : 0`
+/// and `b<0 ? a : 0`.
+///
+/// Example:
+/// ```c++
+/// assert(equal(mulhi((U32x4){} + 0x80000000u, (U32x4){} + 6), (U32x4){} + 3));
+/// assert(equal(mulhi((U16x8){} + 1000, (U16x8){} + 257), (U16x8){} + 3));
+/// ```
+template <typename V>
+V mulhi(const V a, const V b)
+{
+    using T = typename get_base<V>::type;
+    static_assert(std::is_integral_v<T> and (sizeof(T) == 2 or sizeof(T) == 4 or sizeof(T) == 8));
+    using UT = std::make_unsigned_t<T>;
+    using U = typename make<UT, nrelem<V>()>::type;
+    [[maybe_unused]] constexpr bool s = std::is_signed_v<T>;
+
+    if constexpr (false) {}
+    else if constexpr (is_vec<V,16,T> and sizeof(T) == 2) {
+        return (V)(s ? _mm_mulhi_epi16((__m128i)a, (__m128i)b) : _mm_mulhi_epu16((__m128i)a, (__m128i)b));
+    }
+#ifdef __AVX2__
+    else if constexpr (is_vec<V,32,T> and sizeof(T) == 2) {
+        return (V)(s ? _mm256_mulhi_epi16((__m256i)a, (__m256i)b) : _mm256_mulhi_epu16((__m256i)a, (__m256i)b));
+    }
+#endif
+#ifdef __AVX512BW__
+    else if constexpr (is_vec<V,64,T> and sizeof(T) == 2) { // see min
+        return (V)(s ? _mm512_maskz_mulhi_epi16(~0u, (__m512i)a, (__m512i)b)
+                     : _mm512_maskz_mulhi_epu16(~0u, (__m512i)a, (__m512i)b));
+    }
+#endif
+    else if constexpr (sizeof(T) == 2) {
+        using W = typename make<std::conditional_t<s, int32_t, uint32_t>, nrelem<V>()>::type;
+        return __builtin_convertvector((__builtin_convertvector(a, W) * __builtin_convertvector(b, W)) >> 16, V);
+    }
+    else if constexpr (sizeof(V) < 16) { // 64-bit vector of 32-bit elements, widen to 128-bit
+        using WT = std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>;
+        using WV = typename make<WT, nrelem<V>()>::type;
+        return __builtin_convertvector((__builtin_convertvector(a, WV) * __builtin_convertvector(b, WV)) >> 32, V);
+    }
+    else {
+        using W = typename make<uint64_t, sizeof(V)/8>::type;
+        const W lo32 = (W){} + 0xFFFFFFFFu;
+
+        // low 32 bits of x times low 32 bits of y, GCC would use vpmullq otherwise
+        auto mul32 = [&](const W x, const W y) -> W {
+            if constexpr (false) {}
+            else if constexpr (sizeof(W) == 16) {return (W)_mm_mul_epu32((__m128i)x, (__m128i)y);}
+#ifdef __AVX2__
+            else if constexpr (sizeof(W) == 32) {return (W)_mm256_mul_epu32((__m256i)x, (__m256i)y);}
+#endif
+#ifdef __AVX512F__
+            else if constexpr (sizeof(W) == 64) {return (W)_mm512_maskz_mul_epu32(0xFF, (__m512i)x, (__m512i)y);} // see min
+#endif
+            else {return (x & lo32) * (y & lo32);}
+        };
+
+        U hi;
+        if constexpr (sizeof(T) == 4) {
+            const W wa = (W)a, wb = (W)b;
+            const W even = mul32(wa, wb) >> 32;
+            const W odd = mul32(wa >> 32, wb >> 32) & ~lo32;
+            hi = (U)(even | odd);
+        }
+        else {
+            const W ua = (W)a, ub = (W)b;
+            const W a1 = ua >> 32, b1 = ub >> 32;
+            const W p01 = mul32(ua, b1), p10 = mul32(a1, ub);
+            const W mid = (mul32(ua, ub) >> 32) + (p01 & lo32) + (p10 & lo32);
+            hi = (U)(mul32(a1, b1) + (p01 >> 32) + (p10 >> 32) + (mid >> 32));
+        }
+
+        if constexpr (std::is_signed_v<T>) {
+            return (V)hi - (a < 0 ? b : (V){}) - (b < 0 ? a : (V){});
+        }
+        else {
+            return (V)hi;
+        }
+    }
+}
+
+/// Multiplies 16-bit elements and adds adjacent pairs of 32-bit products,
+/// `r[i] = a[2i]*b[2i] + a[2i+1]*b[2i+1]` (`pmaddwd`).
+///
+/// Only `a` and `b` pairs all equal to -32768 overflow, the result wraps to `INT32_MIN`.
+///
+/// Example:
+/// ```c++
+/// I32x4 r = vx::madd_pairs((I16x8){1,2,3,4,5,6,7,8}, (I16x8){} + 1); // {3,7,11,15}
+/// ```
+template <typename V>
+typename make<int32_t, nrelem<V>()/2>::type madd_pairs(const V a, const V b)
+{
+    using T = typename get_base<V>::type;
+    static_assert(std::is_same_v<T, int16_t>);
+    using W = typename make<int32_t, nrelem<V>()/2>::type;
+
+    if constexpr (false) {}
+    else if constexpr (is_vec<V,16,T>)        {return (W)_mm_madd_epi16((__m128i)a, (__m128i)b);}
+#ifdef __AVX2__
+    else if constexpr (is_vec<V,32,T>)        {return (W)_mm256_madd_epi16((__m256i)a, (__m256i)b);}
+#endif
+#ifdef __AVX512BW__
+    else if constexpr (is_vec<V,64,T>)        {return (W)_mm512_maskz_madd_epi16(0xFFFF, (__m512i)a, (__m512i)b);} // see min
+#endif
+    else {
+        // sign extend low and high 16 bits of every 32-bit lane
+        const W wa = (W)a, wb = (W)b;
+        return ((wa << 16) >> 16) * ((wb << 16) >> 16) + (wa >> 16) * (wb >> 16);
+    }
+}
+
+/// Lower half of vector, `{v[0], ..., v[N/2-1]}`.
+template <typename V>
+typename make<typename get_base<V>::type, nrelem<V>()/2>::type lo_half(const V v)
+{
+    using H = typename make<typename get_base<V>::type, nrelem<V>()/2>::type;
+
+    H h;
+    __builtin_memcpy(&h, &v, sizeof h); // GCC turns this into register subreg
+    return h;
+}
+
+/// Upper half of vector, `{v[N/2], ..., v[N-1]}`.
+template <typename V>
+typename make<typename get_base<V>::type, nrelem<V>()/2>::type hi_half(const V v)
+{
+    using H = typename make<typename get_base<V>::type, nrelem<V>()/2>::type;
+
+    if constexpr (false) {}
+#ifdef __AVX512F__
+    // maskz form with full mask: same vextracti64x4, but GCC 12 does not
+    // warn about _mm256_undefined_si256 being uninitialized
+    else if constexpr (sizeof(V) == 64) { return (H)_mm512_maskz_extracti64x4_epi64(0xFF, (__m512i)v, 1); }
+#endif
 #ifdef __AVX__
-static inline void load(F64x4& v, const double* mem) {v = _mm256_load_pd(mem);}
-static inline void load(F64x8& v, const double* mem) {v = _mm512_load_pd(mem);}
+    else if constexpr (sizeof(V) == 32) { return (H)_mm256_extractf128_si256((__m256i)v, 1); }
 #endif
+    else {
+        H h;
+        __builtin_memcpy(&h, (const char*)&v + sizeof h, sizeof h);
+        return h;
+    }
+}
 
-/// Store vector to memory.
-static inline void store(float* mem, const F32x4& v) {_mm_store_ps(mem, v);}
-static inline void store(double* mem, const F64x2& v) {_mm_store_pd(mem, v);}
-static inline void store(double* mem, const F64x4& v) {_mm256_store_pd(mem, v);}
-static inline void store(double* mem, const F64x8& v) {_mm512_store_pd(mem, v);}
+/// Vector made of two halves, inverse of `lo_half` and `hi_half`.
+///
+/// Example:
+/// ```c++
+/// F32x8 v = vx::combine(lo_half(v), hi_half(v));
+/// ```
+template <typename H>
+typename make<typename get_base<H>::type, nrelem<H>()*2>::type combine(const H lo, const H hi)
+{
+    using V = typename make<typename get_base<H>::type, nrelem<H>()*2>::type;
+
+    V v;
+    __builtin_memcpy(&v, &lo, sizeof lo); // vinsertf128/vinsertf64x4
+    __builtin_memcpy((char*)&v + sizeof lo, &hi, sizeof hi);
+    return v;
+}
+
+/// Converts F32 elements to I32 rounding to nearest, ties to even (`cvtps2dq`
+/// in the default rounding mode). `__builtin_convertvector` truncates instead.
+///
+/// NaN and values out of `int32_t` range give `INT32_MIN`.
+///
+/// Example:
+/// ```c++
+/// assert(equal(round_to_int((F32x4){0.5f, 1.5f, -2.6f, 7}), (I32x4){0, 2, -3, 7}));
+/// ```
+template <typename V>
+typename get_mask<V>::type round_to_int(const V a)
+{
+    static_assert(std::is_same_v<typename get_base<V>::type, float> and sizeof(V) >= 16);
+    using I = typename get_mask<V>::type;
+
+    if constexpr (false) {}
+    else if constexpr (is_vec<V,16,float>)    {return (I)_mm_cvtps_epi32((__m128)a);}
+#ifdef __AVX__
+    else if constexpr (is_vec<V,32,float>)    {return (I)_mm256_cvtps_epi32((__m256)a);}
+#endif
+#ifdef __AVX512F__
+    else if constexpr (is_vec<V,64,float>)    {return (I)_mm512_maskz_cvtps_epi32(0xFFFF, (__m512)a);} // see min
+#endif
+    else {
+        return combine(round_to_int(lo_half(a)), round_to_int(hi_half(a)));
+    }
+}
+
+/// Square root of floating point elements, correctly rounded.
+///
+/// Example:
+/// ```c++
+/// F32x8 r = vx::sqrt(x);
+/// ```
+template <typename V>
+V sqrt(const V a)
+{
+    using T = typename get_base<V>::type;
+    static_assert(std::is_floating_point_v<T>);
 
-static inline I8x8  add(I8x8  a, I8x8  b) {return (I8x8) _mm_add_pi8 ((__m64)a, (__m64)b);}
-static inline I16x4 add(I16x4 a, I16x4 b) {return (I16x4)_mm_add_pi16((__m64)a, (__m64)b);}
-static inline I32x2 add(I32x2 a, I32x2 b) {return (I32x2)_mm_add_pi32((__m64)a, (__m64)b);}
-static inline I16x8 add(const I16x8 a, const I16x8 b) {return (I16x8)_mm_add_epi16((__m128i)a, (__m128i)b);}
-static inline I64x2 add(const I64x2 a, const I64x2 b) {return (I64x2)_mm_add_epi64((__m128i)a, (__m128i)b);}
-static inline F64x2 add(const F64x2 a, const F64x2 b) {return (F64x2)_mm_add_pd((__m128d)a, (__m128d)b);}
+    if constexpr (is_vec<V,16,float>)         {return (V)_mm_sqrt_ps((__m128)a);}
+    else if constexpr (is_vec<V,16,double>)   {return (V)_mm_sqrt_pd((__m128d)a);}
+#ifdef __AVX__
+    else if constexpr (is_vec<V,32,float>)    {return (V)_mm256_sqrt_ps((__m256)a);}
+    else if constexpr (is_vec<V,32,double>)   {return (V)_mm256_sqrt_pd((__m256d)a);}
+#endif
+#ifdef __AVX512F__
+    // maskz forms, see min
+    else if constexpr (is_vec<V,64,float>)    {return (V)_mm512_maskz_sqrt_ps(0xFFFF, (__m512)a);}
+    else if constexpr (is_vec<V,64,double>)   {return (V)_mm512_maskz_sqrt_pd(0xFF, (__m512d)a);}
+#endif
+    else if constexpr (sizeof(V) > 16) {
+        return combine(sqrt(lo_half(a)), sqrt(hi_half(a)));
+    }
+    else {
+        V r{};
+        for (unsigned i = 0; i < nrelem<V>(); ++i) { r[i] = __builtin_sqrt(a[i]); }
+        return r;
+    }
+}
 
-static inline I8x8  sub(I8x8  a, I8x8  b) {return (I8x8) _mm_sub_pi8 ((__m64)a, (__m64)b);}
-static inline I16x4 sub(I16x4 a, I16x4 b) {return (I16x4)_mm_sub_pi16((__m64)a, (__m64)b);}
-static inline I32x2 sub(I32x2 a, I32x2 b) {return (I32x2)_mm_sub_pi32((__m64)a, (__m64)b);}
-static inline I16x8 sub(const I16x8 a, const I16x8 b) {return (I16x8)_mm_sub_epi16((__m128i)a, (__m128i)b);}
-static inline I32x4 sub(const I32x4 a, const I32x4 b) {return (I32x4)_mm_sub_epi32((__m128i)a, (__m128i)b);}
-static inline F64x2 sub(const F64x2 a, const F64x2 b) {return (F64x2)_mm_sub_pd((__m128d)a, (__m128d)b);}
-static inline F32x4 sub(const F32x4 a, const F32x4 b) {return (F32x4)_mm_sub_ps((__m128)a, (__m128)b);}
+/// True if `V` has hardware reciprocal and reciprocal square root estimates:
+/// `rcp14`/`rsqrt14` with AVX-512 (F32 and F64), `rcpps`/`rsqrtps` for F32 otherwise.
+template <typename V>
+constexpr bool has_rcp_estimate()
+{
+    using T = typename get_base<V>::type;
+    if constexpr (std::is_same_v<T, float>) {
+        return sizeof(V) >= 16;
+    }
+    else {
+#if defined(__AVX512VL__)
+        return sizeof(V) >= 16;
+#elif defined(__AVX512F__)
+        return sizeof(V) >= 64;
+#else
+        return false;
+#endif
+    }
+}
 
-static inline I8x8  add_saturated(I8x8  a, I8x8  b) {return (I8x8)_mm_adds_pi8((__m64)a, (__m64)b);}
-static inline U8x8  add_saturated(U8x8  a, U8x8  b) {return (U8x8)_mm_adds_pu8((__m64)a, (__m64)b);}
-static inline I16x4 add_saturated(I16x4 a, I16x4 b) {return (I16x4)_mm_adds_pi16((__m64)a, (__m64)b);}
-static inline U16x4 add_saturated(U16x4 a, U16x4 b) {return (U16x4)_mm_adds_pu16((__m64)a, (__m64)b);}
+/// Hardware estimate of `1/a[i]`, relative error below 2^-14 (`rcp14`)
+/// or 1.5*2^-12 (`rcpps`), exact `1/a` when `!has_rcp_estimate<V>()`.
+/// Subnormal arguments give infinity, results below `FLT_MIN`/`DBL_MIN` give zero.
+template <typename V>
+V rcp_estimate(const V a)
+{
+    using T = typename get_base<V>::type;
+    static_assert(std::is_floating_point_v<T>);
 
-static inline I8x16 add_saturated(I8x16 a, I8x16 b) {return (I8x16)_mm_adds_epi8((__m128i)a, (__m128i)b);}
+    if constexpr (!has_rcp_estimate<V>()) {return broadcast<V>(1) / a;}
+#ifdef __AVX512VL__
+    else if constexpr (is_vec<V,16,float>)    {return (V)_mm_rcp14_ps((__m128)a);}
+    else if constexpr (is_vec<V,16,double>)   {return (V)_mm_rcp14_pd((__m128d)a);}
+    else if constexpr (is_vec<V,32,float>)    {return (V)_mm256_rcp14_ps((__m256)a);}
+    else if constexpr (is_vec<V,32,double>)   {return (V)_mm256_rcp14_pd((__m256d)a);}
+#endif
+    else if constexpr (is_vec<V,16,float>)    {return (V)_mm_rcp_ps((__m128)a);}
+#ifdef __AVX__
+    else if constexpr (is_vec<V,32,float>)    {return (V)_mm256_rcp_ps((__m256)a);}
+#endif
+#ifdef __AVX512F__
+    // maskz forms, see min
+    else if constexpr (is_vec<V,64,float>)    {return (V)_mm512_maskz_rcp14_ps(0xFFFF, (__m512)a);}
+    else if constexpr (is_vec<V,64,double>)   {return (V)_mm512_maskz_rcp14_pd(0xFF, (__m512d)a);}
+#endif
+    else {
+        return combine(rcp_estimate(lo_half(a)), rcp_estimate(hi_half(a)));
+    }
+}
 
+/// Hardware estimate of `1/sqrt(a[i])`, error as `rcp_estimate`,
+/// exact `1/sqrt(a)` when `!has_rcp_estimate<V>()`.
+template <typename V>
+V rsqrt_estimate(const V a)
+{
+    using T = typename get_base<V>::type;
+    static_assert(std::is_floating_point_v<T>);
 
-static inline F64x2 mul(const F64x2 a, const F64x2 b) {return (F64x2)_mm_mul_pd((__m128d)a, (__m128d)b);}
+    if constexpr (!has_rcp_estimate<V>()) {return broadcast<V>(1) / sqrt(a);}
+#ifdef __AVX512VL__
+    else if constexpr (is_vec<V,16,float>)    {return (V)_mm_rsqrt14_ps((__m128)a);}
+    else if constexpr (is_vec<V,16,double>)   {return (V)_mm_rsqrt14_pd((__m128d)a);}
+    else if constexpr (is_vec<V,32,float>)    {return (V)_mm256_rsqrt14_ps((__m256)a);}
+    else if constexpr (is_vec<V,32,double>)   {return (V)_mm256_rsqrt14_pd((__m256d)a);}
+#endif
+    else if constexpr (is_vec<V,16,float>)    {return (V)_mm_rsqrt_ps((__m128)a);}
 #ifdef __AVX__
-static inline F64x4 mul(const F64x4 a, const F64x4 b) {return (F64x4)_mm256_mul_pd((__m256d)a, (__m256d)b);}
+    else if constexpr (is_vec<V,32,float>)    {return (V)_mm256_rsqrt_ps((__m256)a);}
+#endif
+#ifdef __AVX512F__
+    else if constexpr (is_vec<V,64,float>)    {return (V)_mm512_maskz_rsqrt14_ps(0xFFFF, (__m512)a);}
+    else if constexpr (is_vec<V,64,double>)   {return (V)_mm512_maskz_rsqrt14_pd(0xFF, (__m512d)a);}
 #endif
+    else {
+        return combine(rsqrt_estimate(lo_half(a)), rsqrt_estimate(hi_half(a)));
+    }
+}
 
-static inline F32x4 madd(F32x4 a, F32x4 b, F32x4 c) {return _mm_fmadd_ps(a, b, c);}
+/// Default number of Newton steps after the estimate, enough for about 1 ulp.
+template <typename T>
+inline constexpr unsigned newton_steps = std::is_same_v<T, float> ? 1 : 2;
 
+/// Reciprocal `1/a[i]`, hardware estimate refined by `Steps` Newton iterations
+/// `r += r*(1 - a*r)`, each one doubles the number of correct bits.
+///
+/// F32 one step is within 1 ulp from `rcp14` and 2 ulp from `rcpps` (3 without FMA),
+/// F64 two steps from `rcp14` are within 1 ulp.
+/// Zeros, infinities and NaN give what `1/a` gives, subnormals as `rcp_estimate`.
+/// Without an estimate instruction it is `1/a`.
+///
+/// Example:
+/// ```c++
+/// F32x8 r = vx::rcp(x);     // default steps
+/// F32x8 q = vx::rcp<0>(x);  // raw estimate
+/// ```
+template <unsigned Steps, typename V>
+V rcp(const V a)
+{
+    const V est = rcp_estimate(a);
+    if constexpr (!has_rcp_estimate<V>()) {return est;}
 
-static inline F64x2 sqrt(const F64x2 a) {return (F64x2)_mm_sqrt_pd((__m128d)a);}
+    const V one = broadcast<V>(1);
+    V r = est;
+    for (unsigned i = 0; i < Steps; ++i) {
+        r = madd(r, nmadd(a, r, one), r);
+    }
+    return r == r ? r : est; // 0*inf in a step, estimate is exact there
+}
 
-static inline void load_gather(F64x2& v, const double* base_addr, I64x2 vindex, const int scale=1) {
-    v = _mm_i64gather_pd(base_addr, (__m128i)vindex, scale);
+template <typename V>
+V rcp(const V a) {return rcp<newton_steps<typename get_base<V>::type>>(a);}
+
+/// Reciprocal square root `1/sqrt(a[i])`, hardware estimate refined by `Steps`
+/// Newton iterations `y += y/2*(1 - a*y*y)`.
+///
+/// F32 one step is within 1.5 ulp from `rsqrt14` and 3 ulp from `rsqrtps` (3.5 without FMA),
+/// F64 two steps from `rsqrt14` are within 1.5 ulp. Without an estimate it is `1/sqrt(a)`.
+/// `+-0` gives `+-inf`, `inf` gives 0, negative and NaN give NaN.
+template <unsigned Steps, typename V>
+V rsqrt(const V a)
+{
+    const V est = rsqrt_estimate(a);
+    if constexpr (!has_rcp_estimate<V>()) {return est;}
+
+    const V one = broadcast<V>(1), half = broadcast<V>(0.5);
+    V y = est;
+    for (unsigned i = 0; i < Steps; ++i) {
+        const V e = nmadd(a * y, y, one);
+        y = madd(y * half, e, y);
+    }
+    return y == y ? y : est;
+}
+
+template <typename V>
+V rsqrt(const V a) {return rsqrt<newton_steps<typename get_base<V>::type>>(a);}
+
+/// Returns bits of the most significant bit of every mask element,
+/// bit `i` corresponds to element `i`.
+///
+/// Example:
+/// ```c++
+/// assert(movemask((I32x4){-1,0,-1,0}) == 0b0101);
+/// ```
+template <typename M>
+uint64_t movemask(M m)
+{
+    [[maybe_unused]] constexpr std::size_t esz = sizeof(typename get_base<M>::type);
+
+    if constexpr (false) {}
+    else if constexpr (sizeof(M) == 16 and esz == 1) { return (uint16_t)_mm_movemask_epi8((__m128i)m); }
+    else if constexpr (sizeof(M) == 16 and esz == 4) { return _mm_movemask_ps((__m128)m); }
+    else if constexpr (sizeof(M) == 16 and esz == 8) { return _mm_movemask_pd((__m128d)m); }
+#ifdef __AVX2__
+    else if constexpr (sizeof(M) == 32 and esz == 1) { return (uint32_t)_mm256_movemask_epi8((__m256i)m); }
+    else if constexpr (sizeof(M) == 32 and esz == 4) { return _mm256_movemask_ps((__m256)m); }
+    else if constexpr (sizeof(M) == 32 and esz == 8) { return _mm256_movemask_pd((__m256d)m); }
+#endif
+#if defined(__AVX512BW__) && defined(__AVX512VL__)
+    else if constexpr (sizeof(M) == 16 and esz == 2) { return _mm_movepi16_mask((__m128i)m); }
+    else if constexpr (sizeof(M) == 32 and esz == 2) { return _mm256_movepi16_mask((__m256i)m); }
+#endif
+#ifdef __AVX512BW__
+    else if constexpr (sizeof(M) == 64 and esz == 1) { return _mm512_movepi8_mask((__m512i)m); }
+    else if constexpr (sizeof(M) == 64 and esz == 2) { return _mm512_movepi16_mask((__m512i)m); }
+#endif
+#ifdef __AVX512F__
+    else if constexpr (sizeof(M) == 64 and esz == 4) {
+        return _mm512_cmplt_epi32_mask((__m512i)m, _mm512_setzero_si512()); }
+    else if constexpr (sizeof(M) == 64 and esz == 8) {
+        return _mm512_cmplt_epi64_mask((__m512i)m, _mm512_setzero_si512()); }
+#endif
+    else {
+        uint64_t bits = 0;
+        for (unsigned i = 0; i < nrelem<M>(); ++i) {
+            bits |= (uint64_t)(m[i] < 0) << i;
+        }
+        return bits;
+    }
+}
+
+/// Get `kmask` type for vector `V`.
+template <typename V>
+using get_kmask = kmask<nrelem<V>()>;
+
+/// Comparison predicate for `vx::compare`.
+enum class cmp {eq, lt, le, ne, ge, gt};
+
+/// Compare elements, returns `kmask` with bit `i` set if `a[i] <C> b[i]`.
+///
+/// With AVX-512 the comparison writes a `k` register directly
+/// (AVX512VL is needed for 128- and 256-bit vectors, AVX512BW for 8/16-bit elements),
+/// otherwise the vector comparison result is packed with `movemask`.
+/// Floating point `ne` is true if either element is NaN, like `!=`.
+///
+/// Example:
+/// ```c++
+/// auto m = compare<cmp::gt>((F64x8){1,2,3,4,5,6,7,8}, (F64x8){} + 4);
+/// assert(m.bits == 0b1111'0000);
+/// ```
+template <cmp C, typename V>
+get_kmask<V> compare(const V a, const V b)
+{
+    using K = get_kmask<V>;
+    using KT = typename K::type;
+
+    [[maybe_unused]] constexpr int fimm =
+        C == cmp::eq ? _CMP_EQ_OQ : C == cmp::lt ? _CMP_LT_OQ : C == cmp::le ? _CMP_LE_OQ :
+        C == cmp::ne ? _CMP_NEQ_UQ : C == cmp::ge ? _CMP_GE_OQ : _CMP_GT_OQ;
+    [[maybe_unused]] constexpr int iimm =
+        C == cmp::eq ? _MM_CMPINT_EQ : C == cmp::lt ? _MM_CMPINT_LT : C == cmp::le ? _MM_CMPINT_LE :
+        C == cmp::ne ? _MM_CMPINT_NE : C == cmp::ge ? _MM_CMPINT_NLT : _MM_CMPINT_NLE;
+
+// one line per element type for 128-, 256- and 512-bit flavors of intrinsics
+#define VX_KCMP(S, W, R) \
+    else if constexpr (is_vec<V,S,float>)    {return K{(KT)_mm##W##_cmp_ps_mask((__m##R)a, (__m##R)b, fimm)};} \
+    else if constexpr (is_vec<V,S,double>)   {return K{(KT)_mm##W##_cmp_pd_mask((__m##R##d)a, (__m##R##d)b, fimm)};} \
+    else if constexpr (is_vec<V,S,int32_t>)  {return K{(KT)_mm##W##_cmp_epi32_mask((__m##R##i)a, (__m##R##i)b, iimm)};} \
+    else if constexpr (is_vec<V,S,uint32_t>) {return K{(KT)_mm##W##_cmp_epu32_mask((__m##R##i)a, (__m##R##i)b, iimm)};} \
+    else if constexpr (is_vec<V,S,int64_t>)  {return K{(KT)_mm##W##_cmp_epi64_mask((__m##R##i)a, (__m##R##i)b, iimm)};} \
+    else if constexpr (is_vec<V,S,uint64_t>) {return K{(KT)_mm##W##_cmp_epu64_mask((__m##R##i)a, (__m##R##i)b, iimm)};}
+#define VX_KCMP_BW(S, W, R) \
+    else if constexpr (is_vec<V,S,int8_t>)   {return K{(KT)_mm##W##_cmp_epi8_mask((__m##R##i)a, (__m##R##i)b, iimm)};} \
+    else if constexpr (is_vec<V,S,uint8_t>)  {return K{(KT)_mm##W##_cmp_epu8_mask((__m##R##i)a, (__m##R##i)b, iimm)};} \
+    else if constexpr (is_vec<V,S,int16_t>)  {return K{(KT)_mm##W##_cmp_epi16_mask((__m##R##i)a, (__m##R##i)b, iimm)};} \
+    else if constexpr (is_vec<V,S,uint16_t>) {return K{(KT)_mm##W##_cmp_epu16_mask((__m##R##i)a, (__m##R##i)b, iimm)};}
+
+    if constexpr (false) {}
+#ifdef __AVX512F__
+    VX_KCMP(64, 512, 512)
+#endif
+#ifdef __AVX512BW__
+    VX_KCMP_BW(64, 512, 512)
+#endif
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+    VX_KCMP(16, , 128)
+    VX_KCMP(32, 256, 256)
+#endif
+#if defined(__AVX512BW__) && defined(__AVX512VL__)
+    VX_KCMP_BW(16, , 128)
+    VX_KCMP_BW(32, 256, 256)
+#endif
+    else {
+        using M = typename get_mask<V>::type;
+        M m;
+        if constexpr (C == cmp::eq) m = (a == b);
+        else if constexpr (C == cmp::lt) m = (a < b);
+        else if constexpr (C == cmp::le) m = (a <= b);
+        else if constexpr (C == cmp::ne) m = (a != b);
+        else if constexpr (C == cmp::ge) m = (a >= b);
+        else m = (a > b);
+        return K{(KT)movemask(m)};
+    }
+#undef VX_KCMP
+#undef VX_KCMP_BW
+}
+
+/// Select elements by mask, `m[i] ? a[i] : src[i]`.
+///
+/// Masked operations are written as an operation followed by `blend`,
+/// GCC folds the pair into a single masked AVX-512 instruction.
+template <typename V>
+V blend(get_kmask<V> m, const V src, const V a)
+{
+    [[maybe_unused]] constexpr std::size_t esz = sizeof(typename get_base<V>::type);
+
+#define VX_KMOV(S, W, R) \
+    else if constexpr (is_vec<V,S,float>)    {return (V)_mm##W##_mask_mov_ps((__m##R)src, m.bits, (__m##R)a);} \
+    else if constexpr (is_vec<V,S,double>)   {return (V)_mm##W##_mask_mov_pd((__m##R##d)src, m.bits, (__m##R##d)a);} \
+    else if constexpr (sizeof(V) == S and esz == 4) {return (V)_mm##W##_mask_mov_epi32((__m##R##i)src, m.bits, (__m##R##i)a);} \
+    else if constexpr (sizeof(V) == S and esz == 8) {return (V)_mm##W##_mask_mov_epi64((__m##R##i)src, m.bits, (__m##R##i)a);}
+#define VX_KMOV_BW(S, W, R) \
+    else if constexpr (sizeof(V) == S and esz == 1) {return (V)_mm##W##_mask_mov_epi8((__m##R##i)src, m.bits, (__m##R##i)a);} \
+    else if constexpr (sizeof(V) == S and esz == 2) {return (V)_mm##W##_mask_mov_epi16((__m##R##i)src, m.bits, (__m##R##i)a);}
+
+    if constexpr (false) {}
+#ifdef __AVX512F__
+    VX_KMOV(64, 512, 512)
+#endif
+#ifdef __AVX512BW__
+    VX_KMOV_BW(64, 512, 512)
+#endif
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+    VX_KMOV(16, , 128)
+    VX_KMOV(32, 256, 256)
+#endif
+#if defined(__AVX512BW__) && defined(__AVX512VL__)
+    VX_KMOV_BW(16, , 128)
+    VX_KMOV_BW(32, 256, 256)
+#endif
+    else {
+        V r = src;
+        for (unsigned i = 0; i < nrelem<V>(); ++i) {
+            if ((m.bits >> i) & 1) r[i] = a[i];
+        }
+        return r;
+    }
+#undef VX_KMOV
+#undef VX_KMOV_BW
+}
+
+/// Masked add, `m[i] ? a[i] + b[i] : src[i]`.
+template <typename V> V add(get_kmask<V> m, const V src, const V a, const V b) {return blend(m, src, add(a, b));}
+/// Masked subtract, `m[i] ? a[i] - b[i] : src[i]`.
+template <typename V> V sub(get_kmask<V> m, const V src, const V a, const V b) {return blend(m, src, sub(a, b));}
+/// Masked multiply, `m[i] ? a[i] * b[i] : src[i]`.
+template <typename V> V mul(get_kmask<V> m, const V src, const V a, const V b) {return blend(m, src, mul(a, b));}
+/// Masked divide, `m[i] ? a[i] / b[i] : src[i]`.
+template <typename V> V div(get_kmask<V> m, const V src, const V a, const V b) {return blend(m, src, div(a, b));}
+/// Masked minimum, `m[i] ? min(a[i], b[i]) : src[i]`.
+template <typename V> V min(get_kmask<V> m, const V src, const V a, const V b) {return blend(m, src, min(a, b));}
+/// Masked maximum, `m[i] ? max(a[i], b[i]) : src[i]`.
+template <typename V> V max(get_kmask<V> m, const V src, const V a, const V b) {return blend(m, src, max(a, b));}
+/// Masked fused multiply-add, `m[i] ? a[i] * b[i] + c[i] : src[i]`.
+template <typename V> V madd(get_kmask<V> m, const V src, const V a, const V b, const V c) {return blend(m, src, madd(a, b, c));}
+
+/// True if any bit of mask is set.
+template <unsigned N> bool any(kmask<N> m) {return m.bits != 0;}
+/// True if bits of all elements are set.
+template <unsigned N> bool all(kmask<N> m) {return m.bits == kmask<N>::ALL;}
+/// True if no bit of mask is set.
+template <unsigned N> bool none(kmask<N> m) {return m.bits == 0;}
+/// Number of set bits.
+template <unsigned N> unsigned popcount(kmask<N> m) {return __builtin_popcountll(m.bits);}
+/// Index of the first set bit, `N` if mask is empty.
+template <unsigned N> unsigned first_set(kmask<N> m) {return m.bits ? __builtin_ctzll(m.bits) : N;}
+
+/// Gather elements from memory, `v[i] = *(base + vindex[i] * Scale)`.
+///
+/// Index vector can have 32- or 64-bit elements and must have
+/// the same number of elements as `v`.
+/// `Scale` is in bytes, by default it is the size of element,
+/// so `vindex` holds element indices.
+///
+/// Example:
+/// ```c++
+/// double table[100];
+/// F64x4 v;
+/// vx::gather(v, table, (I32x4){7,0,99,7});
+/// ```
+template <int Scale = 0, typename V, typename I>
+void gather(V& v, const typename get_base<V>::type* base, I vindex)
+{
+    using T = typename get_base<V>::type;
+    constexpr int scale = Scale ? Scale : sizeof(T);
+    [[maybe_unused]] constexpr std::size_t esz = sizeof(T), isz = sizeof(typename get_base<I>::type);
+    constexpr unsigned n = nrelem<V>();
+    static_assert(n == nrelem<I>(), "one index per element");
+
+    // Gather only moves bits, so float vectors use integer gathers.
+    if constexpr (false) {}
+#ifdef __AVX2__
+    else if constexpr (esz == 4 and isz == 4 and n == 4) {
+        v = (V)_mm_i32gather_epi32((const int*)base, (__m128i)vindex, scale); }
+    else if constexpr (esz == 4 and isz == 4 and n == 8) {
+        v = (V)_mm256_i32gather_epi32((const int*)base, (__m256i)vindex, scale); }
+    else if constexpr (esz == 8 and isz == 4 and n == 2) {
+        v = (V)_mm_i32gather_epi64((const long long*)base, _mm_cvtsi64_si128((int64_t)vindex), scale); }
+    else if constexpr (esz == 8 and isz == 4 and n == 4) {
+        v = (V)_mm256_i32gather_epi64((const long long*)base, (__m128i)vindex, scale); }
+    else if constexpr (esz == 4 and isz == 8 and n == 4) {
+        v = (V)_mm256_i64gather_epi32((const int*)base, (__m256i)vindex, scale); }
+    else if constexpr (esz == 8 and isz == 8 and n == 2) {
+        v = (V)_mm_i64gather_epi64((const long long*)base, (__m128i)vindex, scale); }
+    else if constexpr (esz == 8 and isz == 8 and n == 4) {
+        v = (V)_mm256_i64gather_epi64((const long long*)base, (__m256i)vindex, scale); }
+#endif
+#ifdef __AVX512F__
+    // Zero source instead of _mm512_undefined: it breaks dependency on
+    // old register value and avoids GCC 12 -Wmaybe-uninitialized.
+    else if constexpr (esz == 4 and isz == 4 and n == 16) {
+        v = (V)_mm512_mask_i32gather_epi32(_mm512_setzero_si512(), 0xFFFF, (__m512i)vindex, base, scale); }
+    else if constexpr (esz == 8 and isz == 4 and n == 8) {
+        v = (V)_mm512_mask_i32gather_epi64(_mm512_setzero_si512(), 0xFF, (__m256i)vindex, base, scale); }
+    else if constexpr (esz == 4 and isz == 8 and n == 8) {
+        v = (V)_mm512_mask_i64gather_epi32(_mm256_setzero_si256(), 0xFF, (__m512i)vindex, base, scale); }
+    else if constexpr (esz == 8 and isz == 8 and n == 8) {
+        v = (V)_mm512_mask_i64gather_epi64(_mm512_setzero_si512(), 0xFF, (__m512i)vindex, base, scale); }
+#endif
+    else {
+        V r{};
+        for (unsigned i = 0; i < n; ++i) {
+            r[i] = *(const T*)((const char*)base + (std::ptrdiff_t)vindex[i] * scale);
+        }
+        v = r;
+    }
+}
+
+/// Gather elements selected by mask, other elements of `v` keep their values.
+///
+/// Memory of not selected elements is not accessed.
+template <int Scale = 0, typename V, typename I>
+void mask_gather(V& v, const typename get_base<V>::type* base, I vindex, typename get_mask<V>::type m)
+{
+    using T = typename get_base<V>::type;
+    constexpr int scale = Scale ? Scale : sizeof(T);
+    [[maybe_unused]] constexpr std::size_t esz = sizeof(T), isz = sizeof(typename get_base<I>::type);
+    constexpr unsigned n = nrelem<V>();
+    static_assert(n == nrelem<I>(), "one index per element");
+
+    if constexpr (false) {}
+#ifdef __AVX2__
+    else if constexpr (esz == 4 and isz == 4 and n == 4) {
+        v = (V)_mm_mask_i32gather_epi32((__m128i)v, (const int*)base, (__m128i)vindex, (__m128i)m, scale); }
+    else if constexpr (esz == 4 and isz == 4 and n == 8) {
+        v = (V)_mm256_mask_i32gather_epi32((__m256i)v, (const int*)base, (__m256i)vindex, (__m256i)m, scale); }
+    else if constexpr (esz == 8 and isz == 4 and n == 4) {
+        v = (V)_mm256_mask_i32gather_epi64((__m256i)v, (const long long*)base, (__m128i)vindex, (__m256i)m, scale); }
+    else if constexpr (esz == 4 and isz == 8 and n == 4) {
+        v = (V)_mm256_mask_i64gather_epi32((__m128i)v, (const int*)base, (__m256i)vindex, (__m128i)m, scale); }
+    else if constexpr (esz == 8 and isz == 8 and n == 2) {
+        v = (V)_mm_mask_i64gather_epi64((__m128i)v, (const long long*)base, (__m128i)vindex, (__m128i)m, scale); }
+    else if constexpr (esz == 8 and isz == 8 and n == 4) {
+        v = (V)_mm256_mask_i64gather_epi64((__m256i)v, (const long long*)base, (__m256i)vindex, (__m256i)m, scale); }
+#endif
+#ifdef __AVX512F__
+    else if constexpr (esz == 4 and isz == 4 and n == 16) {
+        v = (V)_mm512_mask_i32gather_epi32((__m512i)v, movemask(m), (__m512i)vindex, base, scale); }
+    else if constexpr (esz == 8 and isz == 4 and n == 8) {
+        v = (V)_mm512_mask_i32gather_epi64((__m512i)v, movemask(m), (__m256i)vindex, base, scale); }
+    else if constexpr (esz == 4 and isz == 8 and n == 8) {
+        v = (V)_mm512_mask_i64gather_epi32((__m256i)v, movemask(m), (__m512i)vindex, base, scale); }
+    else if constexpr (esz == 8 and isz == 8 and n == 8) {
+        v = (V)_mm512_mask_i64gather_epi64((__m512i)v, movemask(m), (__m512i)vindex, base, scale); }
+#endif
+    else {
+        for (unsigned i = 0; i < n; ++i) {
+            if (m[i]) v[i] = *(const T*)((const char*)base + (std::ptrdiff_t)vindex[i] * scale);
+        }
+    }
+}
+
+/// Scatter elements to memory, `*(base + vindex[i] * Scale) = v[i]`.
+///
+/// When indices repeat, the element with the highest lane number is written last.
+/// AVX-512 has scatter instructions, without AVX-512 scatter is emulated
+/// with one store per element.
+template <int Scale = 0, typename V, typename I>
+void scatter(typename get_base<V>::type* base, I vindex, const V& v)
+{
+    using T = typename get_base<V>::type;
+    constexpr int scale = Scale ? Scale : sizeof(T);
+    [[maybe_unused]] constexpr std::size_t esz = sizeof(T), isz = sizeof(typename get_base<I>::type);
+    constexpr unsigned n = nrelem<V>();
+    static_assert(n == nrelem<I>(), "one index per element");
+
+    if constexpr (false) {}
+#ifdef __AVX512F__
+    else if constexpr (esz == 4 and isz == 4 and n == 16) {
+        _mm512_i32scatter_epi32(base, (__m512i)vindex, (__m512i)v, scale); }
+    else if constexpr (esz == 8 and isz == 4 and n == 8) {
+        _mm512_i32scatter_epi64(base, (__m256i)vindex, (__m512i)v, scale); }
+    else if constexpr (esz == 4 and isz == 8 and n == 8) {
+        _mm512_i64scatter_epi32(base, (__m512i)vindex, (__m256i)v, scale); }
+    else if constexpr (esz == 8 and isz == 8 and n == 8) {
+        _mm512_i64scatter_epi64(base, (__m512i)vindex, (__m512i)v, scale); }
+#endif
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+    else if constexpr (esz == 4 and isz == 4 and n == 4) {
+        _mm_i32scatter_epi32(base, (__m128i)vindex, (__m128i)v, scale); }
+    else if constexpr (esz == 4 and isz == 4 and n == 8) {
+        _mm256_i32scatter_epi32(base, (__m256i)vindex, (__m256i)v, scale); }
+    else if constexpr (esz == 8 and isz == 4 and n == 2) {
+        _mm_i32scatter_epi64(base, _mm_cvtsi64_si128((int64_t)vindex), (__m128i)v, scale); }
+    else if constexpr (esz == 8 and isz == 4 and n == 4) {
+        _mm256_i32scatter_epi64(base, (__m128i)vindex, (__m256i)v, scale); }
+    else if constexpr (esz == 4 and isz == 8 and n == 4) {
+        _mm256_i64scatter_epi32(base, (__m256i)vindex, (__m128i)v, scale); }
+    else if constexpr (esz == 8 and isz == 8 and n == 2) {
+        _mm_i64scatter_epi64(base, (__m128i)vindex, (__m128i)v, scale); }
+    else if constexpr (esz == 8 and isz == 8 and n == 4) {
+        _mm256_i64scatter_epi64(base, (__m256i)vindex, (__m256i)v, scale); }
+#endif
+    else {
+        for (unsigned i = 0; i < n; ++i) {
+            *(T*)((char*)base + (std::ptrdiff_t)vindex[i] * scale) = v[i];
+        }
+    }
+}
+
+/// Scatter elements selected by mask, memory of other elements is not touched.
+template <int Scale = 0, typename V, typename I>
+void mask_scatter(typename get_base<V>::type* base, I vindex, const V& v, typename get_mask<V>::type m)
+{
+    using T = typename get_base<V>::type;
+    constexpr int scale = Scale ? Scale : sizeof(T);
+    [[maybe_unused]] constexpr std::size_t esz = sizeof(T), isz = sizeof(typename get_base<I>::type);
+    constexpr unsigned n = nrelem<V>();
+    static_assert(n == nrelem<I>(), "one index per element");
+
+    if constexpr (false) {}
+#ifdef __AVX512F__
+    else if constexpr (esz == 4 and isz == 4 and n == 16) {
+        _mm512_mask_i32scatter_epi32(base, movemask(m), (__m512i)vindex, (__m512i)v, scale); }
+    else if constexpr (esz == 8 and isz == 4 and n == 8) {
+        _mm512_mask_i32scatter_epi64(base, movemask(m), (__m256i)vindex, (__m512i)v, scale); }
+    else if constexpr (esz == 4 and isz == 8 and n == 8) {
+        _mm512_mask_i64scatter_epi32(base, movemask(m), (__m512i)vindex, (__m256i)v, scale); }
+    else if constexpr (esz == 8 and isz == 8 and n == 8) {
+        _mm512_mask_i64scatter_epi64(base, movemask(m), (__m512i)vindex, (__m512i)v, scale); }
+#endif
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+    else if constexpr (esz == 4 and isz == 4 and n == 4) {
+        _mm_mask_i32scatter_epi32(base, movemask(m), (__m128i)vindex, (__m128i)v, scale); }
+    else if constexpr (esz == 4 and isz == 4 and n == 8) {
+        _mm256_mask_i32scatter_epi32(base, movemask(m), (__m256i)vindex, (__m256i)v, scale); }
+    else if constexpr (esz == 8 and isz == 4 and n == 4) {
+        _mm256_mask_i32scatter_epi64(base, movemask(m), (__m128i)vindex, (__m256i)v, scale); }
+    else if constexpr (esz == 4 and isz == 8 and n == 4) {
+        _mm256_mask_i64scatter_epi32(base, movemask(m), (__m256i)vindex, (__m128i)v, scale); }
+    else if constexpr (esz == 8 and isz == 8 and n == 2) {
+        _mm_mask_i64scatter_epi64(base, movemask(m), (__m128i)vindex, (__m128i)v, scale); }
+    else if constexpr (esz == 8 and isz == 8 and n == 4) {
+        _mm256_mask_i64scatter_epi64(base, movemask(m), (__m256i)vindex, (__m256i)v, scale); }
+#endif
+    else {
+        for (unsigned i = 0; i < n; ++i) {
+            if (m[i]) *(T*)((char*)base + (std::ptrdiff_t)vindex[i] * scale) = v[i];
+        }
+    }
+}
+
+/// Gather with run-time scale in bytes, `v[i] = *(base_addr + vindex[i] * scale)`.
+template <typename V, typename I>
+void load_gather(V& v, const typename get_base<V>::type* base_addr, I vindex, const int scale=1)
+{
+    gather<1>(v, base_addr, vindex * scale);
+}
+
+/// Temporal locality hint for `vx::prefetch`.
+enum class locality {
+    NTA = _MM_HINT_NTA, ///< non-temporal, bring close but avoid polluting caches
+    T2  = _MM_HINT_T2,  ///< bring into L3 and higher
+    T1  = _MM_HINT_T1,  ///< bring into L2 and higher
+    T0  = _MM_HINT_T0   ///< bring into all cache levels
+};
+
+/// Software prefetch of the cache line that contains `mem`.
+///
+/// Prefetch never faults, it is safe to prefetch past the end of a buffer.
+///
+/// Example:
+/// ```c++
+/// vx::prefetch(&b[i + distance]);
+/// vx::prefetch<vx::locality::NTA>(&stream[i + distance]);
+/// ```
+template <locality L = locality::T0>
+inline void prefetch(const void* mem) {
+    _mm_prefetch((const char*)mem, (enum _mm_hint)L);
 }
 
 } // namespace vx
@@ -24,6 +24,7 @@
 #pragma once
 
 #include <cstdint>
+#include <type_traits>
 #include <immintrin.h>
 
 /// Namespace of all vector types and functions.
@@ -87,6 +88,24 @@ VX_DEF8 (double,F64,d)
 const std::size_t MIN_VSIZE = 64/8;
 const std::size_t MAX_VSIZE = 512/8;
 
+/// Size of the widest vector register enabled by compiler flags.
+#if defined(__AVX512F__)
+const std::size_t NATIVE_VSIZE = 512/8;
+#elif defined(__AVX__)
+const std::size_t NATIVE_VSIZE = 256/8;
+#else
+const std::size_t NATIVE_VSIZE = 128/8;
+#endif
+
+/// Vector of `T` that fills the widest enabled vector register.
+///
+/// Example:
+/// ```c++
+/// vx::native<float> v; // F32x16 with AVX-512, F32x8 with AVX, F32x4 otherwise
+/// ```
+template <typename T>
+using native = typename make<T, NATIVE_VSIZE/sizeof(T)>::type;
+
 union Vec64 {
     __m64 mm;
     U8x8     u8; I8x8   i8;
@@ -140,6 +159,50 @@ struct get_base {
     typedef decltype(((T){})[0]) type;
 };
 
+/// Get mask type of vector, the signed integer vector type
+/// with the same number and width of elements, returned by `a == b`.
+///
+/// Example:
+/// ```c++
+/// static_assert(std::is_same<vx::get_mask<F32x4>::type, I32x4>::value);
+/// ```
+template <typename T>
+struct get_mask {
+    typedef decltype(((T){}) == ((T){})) type;
+};
+
+/// AVX-512 style mask with one bit per element of `N`-element vector.
+///
+/// The bits are kept in `__mmask8/16/32/64`, so with AVX-512 masks live
+/// in `k` registers. Masks are returned by `vx::compare` and consumed by
+/// masked operations like `vx::add(m, src, a, b)`.
+///
+/// Example:
+/// ```c++
+/// kmask<16> m = compare<cmp::lt>(a, b);
+/// F32x16 c = vx::add(m, a, a, b); // c[i] = a[i] < b[i] ? a[i] + b[i] : a[i]
+/// ```
+template <unsigned N>
+struct kmask
+{
+    using type =
+        std::conditional_t<(N <= 8),  __mmask8,
+        std::conditional_t<(N <= 16), __mmask16,
+        std::conditional_t<(N <= 32), __mmask32, __mmask64>>>;
+
+    /// Bits of elements that exist in vector.
+    static constexpr type ALL = (N == sizeof(type)*8) ? (type)~(type)0 : (type)((1ULL << N) - 1);
+
+    type bits;
+
+    friend kmask operator&(kmask a, kmask b) {return {(type)(a.bits & b.bits)};}
+    friend kmask operator|(kmask a, kmask b) {return {(type)(a.bits | b.bits)};}
+    friend kmask operator^(kmask a, kmask b) {return {(type)(a.bits ^ b.bits)};}
+    friend kmask operator~(kmask a) {return {(type)(~a.bits & ALL)};}
+    friend bool operator==(kmask a, kmask b) {return a.bits == b.bits;}
+    friend bool operator!=(kmask a, kmask b) {return a.bits != b.bits;}
+};
+
 /// Compile-time function that returns number of elements.
 ///
 /// Example:
@@ -175,10 +238,18 @@ bool equal(T a, T b)
 {
     T cmp = (a == b);
 
-    if constexpr (sizeof(T) == 32) {
+    if constexpr (false) {}
+#ifdef __AVX512F__
+    else if constexpr (sizeof(T) == 64) {
+        return _mm512_cmpneq_epi64_mask((__m512i)cmp, _mm512_set1_epi64(-1)) == 0;
+    }
+#endif
+#ifdef __AVX2__
+    else if constexpr (sizeof(T) == 32) {
         unsigned bitmask = _mm256_movemask_epi8((__m256i)cmp);
         return (bitmask == 0xffff'ffffU);
     }
+#endif
     else if constexpr (sizeof(T) == 16) {
         unsigned bitmask = _mm_movemask_epi8((__m128i)cmp);
         return (bitmask == 0xffffU);
@@ -186,6 +257,12 @@ bool equal(T a, T b)
     else if constexpr (sizeof(T) == 8) {
         return (uint64_t)cmp == 0xffff'ffff'ffff'ffffUL;
     }
+    else {
+        for (unsigned i = 0; i < nrelem<T>(); ++i) {
+            if (a[i] != b[i]) return false;
+        }
+        return true;
+    }
 }
 
 